@@ -0,0 +1,409 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "ptcore/parser.h"
+#include "ptcore/stream.h"
+
+#if defined(__linux__)
+#include <cerrno>
+#include <sys/epoll.h>
+#include <unistd.h>
+#define PTCORE_HAS_EPOLL 1
+#else
+#define PTCORE_HAS_EPOLL 0
+#endif
+
+namespace ptcore
+{
+    // A coroutine that produces values for another coroutine, which pulls
+    // them one at a time with co_await next(). The producer only runs
+    // while the consumer waits for a value, so at most one value is ever
+    // buffered and a slow consumer holds back the producer.
+    template <typename T>
+    class async_generator
+    {
+    public:
+        struct promise_type
+        {
+            // resumes the consumer when the producer yields or finishes
+            struct transfer
+            {
+                bool await_ready() noexcept { return false; }
+
+                std::coroutine_handle<> await_suspend(
+                    std::coroutine_handle<promise_type> h) noexcept
+                {
+                    return h.promise().consumer;
+                }
+
+                void await_resume() noexcept {}
+            };
+
+            async_generator get_return_object()
+            {
+                return async_generator{
+                    std::coroutine_handle<promise_type>::from_promise(*this) };
+            }
+
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            transfer final_suspend() noexcept { return {}; }
+
+            transfer yield_value(T v)
+            {
+                value.emplace(std::move(v));
+                return {};
+            }
+
+            void return_void() {}
+
+            void unhandled_exception() { error = std::current_exception(); }
+
+            std::optional<T> value;
+            std::exception_ptr error;
+            std::coroutine_handle<> consumer;
+        };
+
+        using handle_t = std::coroutine_handle<promise_type>;
+
+        async_generator(async_generator&& other) noexcept
+            : h_{ std::exchange(other.h_, {}) }
+        {
+        }
+
+        async_generator& operator=(async_generator&& other) noexcept
+        {
+            if (this != &other)
+            {
+                destroy();
+                h_ = std::exchange(other.h_, {});
+            }
+
+            return *this;
+        }
+
+        ~async_generator() { destroy(); }
+
+        // co_await next() runs the producer up to its next value, which it
+        // returns, or nullopt once the producer has finished. An exception
+        // thrown by the producer is rethrown here.
+        auto next()
+        {
+            struct awaiter
+            {
+                bool await_ready() { return h.done(); }
+
+                std::coroutine_handle<> await_suspend(
+                    std::coroutine_handle<> consumer)
+                {
+                    h.promise().value.reset();
+                    h.promise().consumer = consumer;
+                    return h;
+                }
+
+                std::optional<T> await_resume()
+                {
+                    auto& promise = h.promise();
+                    if (promise.error)
+                    {
+                        std::rethrow_exception(
+                            std::exchange(promise.error, {}));
+                    }
+
+                    if (h.done())
+                    {
+                        return std::nullopt;
+                    }
+
+                    return std::move(promise.value);
+                }
+
+                handle_t h;
+            };
+
+            return awaiter{ h_ };
+        }
+
+    private:
+        explicit async_generator(handle_t h) : h_{ h } {}
+
+        void destroy()
+        {
+            if (h_)
+            {
+                h_.destroy();
+            }
+        }
+
+        handle_t h_;
+    };
+
+    // An eagerly started coroutine whose result is only an exception, if
+    // one escaped it.
+    class async_task
+    {
+    public:
+        struct promise_type
+        {
+            async_task get_return_object()
+            {
+                return async_task{
+                    std::coroutine_handle<promise_type>::from_promise(*this) };
+            }
+
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+
+            void return_void() {}
+
+            void unhandled_exception() { error = std::current_exception(); }
+
+            std::exception_ptr error;
+        };
+
+        using handle_t = std::coroutine_handle<promise_type>;
+
+        async_task(async_task&& other) noexcept
+            : h_{ std::exchange(other.h_, {}) }
+        {
+        }
+
+        async_task& operator=(async_task&&) = delete;
+
+        ~async_task()
+        {
+            if (h_)
+            {
+                h_.destroy();
+            }
+        }
+
+        bool done() const { return h_.done(); }
+
+        // Rethrows the exception that ended the coroutine, if any.
+        // Precondition: done()
+        void get() const
+        {
+            if (h_.promise().error)
+            {
+                std::rethrow_exception(h_.promise().error);
+            }
+        }
+
+    private:
+        explicit async_task(handle_t h) : h_{ h } {}
+
+        handle_t h_;
+    };
+
+#if PTCORE_HAS_EPOLL
+    // Resumes coroutines when the file descriptors they wait on become
+    // readable, so a single thread can serve many streams. The loop must
+    // outlive the coroutines that wait on it.
+    class event_loop
+    {
+    public:
+        event_loop()
+            : epoll_fd_{ ::epoll_create1(EPOLL_CLOEXEC) }, events_(64)
+        {
+            if (epoll_fd_ < 0)
+            {
+                throw std::system_error{ errno, std::generic_category(),
+                                         "epoll_create1" };
+            }
+        }
+
+        event_loop(event_loop const&) = delete;
+        event_loop& operator=(event_loop const&) = delete;
+
+        ~event_loop() { ::close(epoll_fd_); }
+
+        // co_await readable(fd) suspends until fd has data, has reached
+        // end of file, or has an error. Only one coroutine may wait on an
+        // fd at a time. Destroying a coroutine while it waits, as the
+        // destructor of its async_generator or async_task does, withdraws
+        // the wait.
+        auto readable(int fd)
+        {
+            struct awaiter
+            {
+                // the awaiter lives in the frame of the waiting coroutine,
+                // so it goes with the frame if that is destroyed first
+                ~awaiter()
+                {
+                    if (waiting)
+                    {
+                        loop->unwatch(fd, waiting);
+                    }
+                }
+
+                bool await_ready() { return false; }
+
+                void await_suspend(std::coroutine_handle<> h)
+                {
+                    loop->watch(fd, h);
+                    waiting = h;
+                }
+
+                void await_resume() { waiting = {}; }
+
+                event_loop* loop;
+                int fd;
+                std::coroutine_handle<> waiting{};
+            };
+
+            return awaiter{ this, fd };
+        }
+
+        // Runs until no coroutine waits on a file descriptor.
+        void run()
+        {
+            while (waiting_ > 0)
+            {
+                const int n = ::epoll_wait(epoll_fd_, events_.data(),
+                                           static_cast<int>(events_.size()),
+                                           -1);
+                if (n < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+
+                    throw std::system_error{ errno, std::generic_category(),
+                                             "epoll_wait" };
+                }
+
+                ready_ = n;
+                for (next_ = 0; next_ < ready_;)
+                {
+                    // null if its coroutine was destroyed by one resumed
+                    // before it
+                    void* const waiting = events_[next_++].data.ptr;
+                    if (waiting)
+                    {
+                        --waiting_;
+                        std::coroutine_handle<>::from_address(waiting).resume();
+                    }
+                }
+
+                ready_ = 0;
+            }
+        }
+
+    private:
+        // The registration is one shot, so an fd that is waited on again
+        // only needs rearming.
+        void watch(int fd, std::coroutine_handle<> h)
+        {
+            epoll_event event{};
+            event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+            event.data.ptr = h.address();
+
+            if (::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &event) != 0 &&
+                (errno != ENOENT ||
+                 ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) != 0))
+            {
+                throw std::system_error{ errno, std::generic_category(),
+                                         "epoll_ctl" };
+            }
+
+            ++waiting_;
+        }
+
+        // Withdraws the wait of h, which is being destroyed, including an
+        // event for it that run() has taken from epoll but not handled.
+        void unwatch(int fd, std::coroutine_handle<> h) noexcept
+        {
+            ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+            --waiting_;
+
+            for (int i = next_; i < ready_; ++i)
+            {
+                if (events_[i].data.ptr == h.address())
+                {
+                    events_[i].data.ptr = nullptr;
+                }
+            }
+        }
+
+        int epoll_fd_;
+        std::size_t waiting_{0};
+
+        // the events of the current epoll_wait, up to ready_, of which
+        // run() handles next_ next
+        std::vector<epoll_event> events_;
+        int ready_{0};
+        int next_{0};
+    };
+
+    struct fd_parse_options
+    {
+        // bytes read from the fd at a time
+        std::size_t chunk_size{std::size_t{1} << 16};
+
+        stream_options stream{};
+    };
+
+    // Parses back to back p values from fd, which should be non-blocking,
+    // as they arrive. The coroutine waits on loop whenever the fd has no
+    // data. A value may refer to the read buffer and is valid until the
+    // next co_await next(). Input that does not match throws a
+    // std::system_error with std::errc::bad_message, as do read errors
+    // with their errno.
+    template <parser P>
+    async_generator<parser_parse_type<P const&>> parse_fd(
+        event_loop& loop, int fd, P p, fd_parse_options opts = {})
+    {
+        stream_parser<P> sp{ std::move(p), opts.stream };
+        std::vector<char> buffer(opts.chunk_size);
+
+        for (;;)
+        {
+            switch (sp.next())
+            {
+                case parse_status::complete:
+                    co_yield std::move(sp.value());
+                    break;
+
+                case parse_status::need_more_input:
+                {
+                    const auto n = ::read(fd, buffer.data(), buffer.size());
+                    if (n > 0)
+                    {
+                        sp.feed({ buffer.data(), static_cast<std::size_t>(n) });
+                    }
+                    else if (n == 0)
+                    {
+                        sp.finish();
+                    }
+                    else if (errno == EAGAIN || errno == EWOULDBLOCK)
+                    {
+                        co_await loop.readable(fd);
+                    }
+                    else if (errno != EINTR)
+                    {
+                        throw std::system_error{ errno, std::generic_category(),
+                                                 "read" };
+                    }
+                    break;
+                }
+
+                case parse_status::failed:
+                    throw std::system_error{
+                        std::make_error_code(std::errc::bad_message),
+                        "parse_fd" };
+
+                case parse_status::end_of_input:
+                    co_return;
+            }
+        }
+    }
+#endif
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+#include "ptcore/parser.h"
+#include "ptcore/detail/digit_field.h"
+#include "ptcore/detail/simd.h"
+
+namespace ptcore
+{
+    // The results of a batch parse as a structure of arrays, in storage
+    // owned by the caller, with an element for every input.
+    template <typename T>
+    struct batch_output
+    {
+        // values[i] is the value of input i where matched[i] is true, and
+        // unspecified elsewhere
+        std::span<T> values;
+        std::span<bool> matched;
+    };
+
+    namespace detail
+    {
+        // Inputs are usually scattered over memory, so the bytes of the
+        // input this far ahead are requested while the current one is
+        // parsed.
+        inline constexpr std::size_t batch_prefetch_distance = 8;
+
+        inline void prefetch_input(std::span<const parse_input_t> inputs,
+                                   std::size_t i)
+        {
+            if (i + batch_prefetch_distance < inputs.size())
+            {
+                prefetch(inputs[i + batch_prefetch_distance].data());
+            }
+        }
+
+        template <typename P, typename T>
+        bool parse_entirely(P const& p, parse_input_t s, T& out)
+        {
+            parse_cursor c{ s };
+            return ptcore::parse_into(p, c, out) && c.empty();
+        }
+
+        template <typename P, typename T>
+        std::size_t parse_batch_generic(P const& p,
+                                        std::span<const parse_input_t> inputs,
+                                        batch_output<T> const& out)
+        {
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < inputs.size(); ++i)
+            {
+                prefetch_input(inputs, i);
+
+                const bool ok = parse_entirely(p, inputs[i], out.values[i]);
+                out.matched[i] = ok;
+                count += ok;
+            }
+
+            return count;
+        }
+
+#if PTCORE_SIMD_X86
+        // For parsers of exactly a run of digits, every input of up to 16
+        // bytes is converted by the same straight line SIMD code, so the
+        // outcome of one input does not cost a mispredicted branch on the
+        // next.
+        template <typename P, typename T>
+        PTCORE_TARGET("ssse3")
+        std::size_t parse_batch_digits(P const& p,
+                                       std::span<const parse_input_t> inputs,
+                                       batch_output<T> const& out)
+        {
+            constexpr std::uint64_t max = std::numeric_limits<T>::max();
+
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < inputs.size(); ++i)
+            {
+                prefetch_input(inputs, i);
+
+                const auto s = inputs[i];
+                bool ok;
+                // 1 to 16 bytes; an empty input wraps around
+                if (s.size() - 1 < 16)
+                {
+                    std::uint64_t v;
+                    ok = parse_digit_field(s, v) & (v <= max);
+                    out.values[i] = static_cast<T>(v);
+                }
+                else
+                {
+                    ok = parse_entirely(p, s, out.values[i]);
+                }
+
+                out.matched[i] = ok;
+                count += ok;
+            }
+
+            return count;
+        }
+#endif
+    }
+
+    // Parses every input with match_entirety(p) semantics into out, which
+    // must have room for inputs.size() results, and returns the number of
+    // inputs that matched. Meant for many short independent inputs, where
+    // a call per input costs more than the parse: the loop prefetches the
+    // inputs ahead of the parse, writes each result without branching on
+    // it, and for parsers of digit runs, such as match_integer<unsigned>(),
+    // converts each input with SIMD instead of a loop over its digits.
+    template <parser P>
+    std::size_t parse_batch(P const& p,
+                            std::span<const parse_input_t> inputs,
+                            batch_output<parser_parse_type<P const&>> out)
+    {
+#if PTCORE_SIMD_X86
+        if constexpr (detail::digits_only_parser<P>)
+        {
+            if (detail::cpu_simd_level() != detail::simd_level::scalar)
+            {
+                return detail::parse_batch_digits(p, inputs, out);
+            }
+        }
+#endif
+        return detail::parse_batch_generic(p, inputs, out);
+    }
+}
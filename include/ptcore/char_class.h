@@ -0,0 +1,149 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace ptcore
+{
+    namespace detail
+    {
+        struct char_class_scanner;
+    }
+
+    // A set of byte values. Membership is stored both as a 256 bit set for
+    // contains and constant evaluation and as a pair of nibble lookup tables
+    // that let the scans of char_parsers.h classify 16 or 32 bytes with a
+    // few shuffles.
+    class char_class
+    {
+    public:
+        constexpr char_class() = default;
+
+        constexpr explicit char_class(std::string_view members)
+        {
+            for (const auto ch : members)
+            {
+                set(static_cast<unsigned char>(ch));
+            }
+
+            update_tables();
+        }
+
+        static constexpr char_class range(char first, char last)
+        {
+            char_class ret;
+            for (auto b = static_cast<unsigned char>(first);
+                 b <= static_cast<unsigned char>(last); ++b)
+            {
+                ret.set(b);
+                if (b == 0xff)
+                {
+                    break;
+                }
+            }
+
+            ret.update_tables();
+            return ret;
+        }
+
+        constexpr bool contains(char ch) const
+        {
+            const auto b = static_cast<unsigned char>(ch);
+            return ((bits_[b >> 6] >> (b & 63)) & 1) != 0;
+        }
+
+        constexpr bool empty() const
+        {
+            return (bits_[0] | bits_[1] | bits_[2] | bits_[3]) == 0;
+        }
+
+        constexpr std::size_t size() const
+        {
+            std::size_t ret = 0;
+            for (const auto word : bits_)
+            {
+                ret += static_cast<std::size_t>(std::popcount(word));
+            }
+            return ret;
+        }
+
+        friend constexpr char_class operator|(char_class const& lhs,
+                                              char_class const& rhs)
+        {
+            return combine(lhs, rhs, [](auto a, auto b) { return a | b; });
+        }
+
+        friend constexpr char_class operator&(char_class const& lhs,
+                                              char_class const& rhs)
+        {
+            return combine(lhs, rhs, [](auto a, auto b) { return a & b; });
+        }
+
+        friend constexpr char_class operator~(char_class const& c)
+        {
+            return combine(c, c, [](auto a, auto) { return ~a; });
+        }
+
+        bool operator==(char_class const&) const = default;
+
+    private:
+        friend struct detail::char_class_scanner;
+
+        constexpr void set(unsigned char b)
+        {
+            bits_[b >> 6] |= std::uint64_t{1} << (b & 63);
+        }
+
+        template <typename Op>
+        static constexpr char_class combine(char_class const& lhs,
+                                            char_class const& rhs,
+                                            Op op)
+        {
+            char_class ret;
+            for (std::size_t i = 0; i < ret.bits_.size(); ++i)
+            {
+                ret.bits_[i] = op(lhs.bits_[i], rhs.bits_[i]);
+            }
+
+            ret.update_tables();
+            return ret;
+        }
+
+        // low_[n] has bit h set when (h << 4 | n) is a member, for h < 8;
+        // high_[n] holds the same for h >= 8.
+        constexpr void update_tables()
+        {
+            low_ = {};
+            high_ = {};
+
+            for (unsigned b = 0; b < 256; ++b)
+            {
+                if (contains(static_cast<char>(b)))
+                {
+                    const auto hi = b >> 4;
+                    auto& table = hi < 8 ? low_ : high_;
+                    table[b & 0x0f] |= static_cast<std::uint8_t>(1u << (hi & 7));
+                }
+            }
+        }
+
+        std::array<std::uint64_t, 4> bits_{};
+        std::array<std::uint8_t, 16> low_{};
+        std::array<std::uint8_t, 16> high_{};
+    };
+
+    namespace char_classes
+    {
+        inline constexpr char_class digit = char_class::range('0', '9');
+        inline constexpr char_class hex_digit =
+            digit | char_class::range('a', 'f') | char_class::range('A', 'F');
+        inline constexpr char_class alpha =
+            char_class::range('a', 'z') | char_class::range('A', 'Z');
+        inline constexpr char_class alnum = alpha | digit;
+        inline constexpr char_class identifier = alnum | char_class{ "_" };
+        inline constexpr char_class space = char_class{ " \t\n\v\f\r" };
+    }
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+#include "ptcore/parser.h"
+#include "ptcore/char_class.h"
+#include "ptcore/detail/char_class_scan.h"
+
+namespace ptcore
+{
+    // The number of leading characters of s that are members of cls.
+    constexpr std::size_t scan_while(char_class const& cls,
+                                     std::string_view s)
+    {
+        return detail::char_class_scanner::scan(cls, s, true);
+    }
+
+    // The number of leading characters of s that are not members of cls.
+    constexpr std::size_t scan_until(char_class const& cls,
+                                     std::string_view s)
+    {
+        return detail::char_class_scanner::scan(cls, s, false);
+    }
+
+    namespace detail
+    {
+        struct literal_char_parser
+        {
+            constexpr parse_return_t<char> operator()(parse_input_t s) const
+            {
+                if (!s.empty() && s.front() == ch)
+                {
+                    return parse_results{ ch, s.substr(1) };
+                }
+
+                return std::nullopt;
+            }
+
+            constexpr bool parse_into(parse_cursor& c, char& out) const
+            {
+                if (!c.empty() && *c.pos == ch)
+                {
+                    out = ch;
+                    ++c.pos;
+                    return true;
+                }
+
+                return false;
+            }
+
+            constexpr char literal() const { return ch; }
+
+            constexpr bool incomplete(parse_input_t s) const
+            {
+                return s.empty();
+            }
+
+            constexpr parser_info info() const
+            {
+                return { char_class{ parse_input_t{ &ch, 1 } }, 1, 1 };
+            }
+
+            char ch;
+        };
+
+        struct class_char_parser
+        {
+            constexpr parse_return_t<char> operator()(parse_input_t s) const
+            {
+                if (!s.empty() && cls.contains(s.front()))
+                {
+                    return parse_results{ s.front(), s.substr(1) };
+                }
+
+                return std::nullopt;
+            }
+
+            constexpr bool parse_into(parse_cursor& c, char& out) const
+            {
+                if (!c.empty() && cls.contains(*c.pos))
+                {
+                    out = *c.pos++;
+                    return true;
+                }
+
+                return false;
+            }
+
+            constexpr bool incomplete(parse_input_t s) const
+            {
+                return s.empty();
+            }
+
+            constexpr parser_info info() const { return { cls, 1, 1 }; }
+
+            char_class cls;
+        };
+
+        // Matches the longest run of members of cls, failing if it is
+        // shorter than min_length.
+        struct class_run_parser
+        {
+            constexpr parse_return_t<parse_input_t> operator()(
+                parse_input_t s) const
+            {
+                if (const auto n = ptcore::scan_while(cls, s); n >= min_length)
+                {
+                    return parse_results{ s.substr(0, n), s.substr(n) };
+                }
+
+                return std::nullopt;
+            }
+
+            // A run too short to match can only grow if it reaches the
+            // end of s.
+            constexpr bool incomplete(parse_input_t s) const
+            {
+                return ptcore::scan_while(cls, s) == s.size();
+            }
+
+            constexpr parser_info info() const
+            {
+                return { cls, min_length, parser_info::unbounded };
+            }
+
+            char_class cls;
+            std::size_t min_length;
+        };
+    }
+
+    // Matches exactly the character ch.
+    constexpr auto match_char(char ch)
+    {
+        return detail::literal_char_parser{ ch };
+    }
+
+    // Matches a single character that is a member of the class.
+    constexpr auto match_char(char_class cls)
+    {
+        return detail::class_char_parser{ cls };
+    }
+
+    // Matches one or more members of the class.
+    constexpr auto match_run(char_class cls)
+    {
+        return detail::class_run_parser{ cls, 1 };
+    }
+
+    // Matches zero or more members of the class; never fails.
+    constexpr auto skip_while(char_class cls)
+    {
+        return detail::class_run_parser{ cls, 0 };
+    }
+
+    // Matches zero or more characters up to, but not including, the first
+    // member of the class; never fails.
+    constexpr auto take_until(char_class cls)
+    {
+        return detail::class_run_parser{ ~cls, 0 };
+    }
+}
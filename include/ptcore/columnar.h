@@ -0,0 +1,208 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ptcore/parser.h"
+
+namespace ptcore
+{
+    // The fields of a delimited record: the parsers of its columns, in
+    // order, and the separator between them.
+    template <typename Separator, typename... Fields>
+    struct record_schema
+    {
+        Separator sep;
+        std::tuple<Fields...> fields;
+    };
+
+    template <parser Separator, parser... Fields>
+    requires(sizeof...(Fields) > 0)
+    constexpr auto make_record_schema(Separator&& sep, Fields&&... fields)
+    {
+        return record_schema<std::remove_cvref_t<Separator>,
+                             std::remove_cvref_t<Fields>...>{
+            std::forward<Separator>(sep),
+            { std::forward<Fields>(fields)... } };
+    }
+
+    // Parsed records stored a column at a time: column<I>() holds field I
+    // of every row contiguously, ready to be handed to code that works on
+    // whole columns. Every allocation, the columns' and the error
+    // bitmap's, comes from the memory resource given at construction,
+    // typically a monotonic arena released after the columns are used.
+    //
+    // A row that does not match the schema is kept, so row i is element i
+    // of every column, and is marked in the error bitmap; its elements are
+    // unspecified.
+    template <typename... Ts>
+    class record_columns
+    {
+    public:
+        static constexpr std::size_t column_count = sizeof...(Ts);
+
+        explicit record_columns(std::pmr::memory_resource* mr =
+                                    std::pmr::get_default_resource())
+            : columns_{ std::pmr::vector<Ts>{ mr }... },
+              errors_{ mr }
+        {
+        }
+
+        std::size_t rows() const { return rows_; }
+
+        template <std::size_t I>
+        std::span<const std::tuple_element_t<I, std::tuple<Ts...>>>
+            column() const
+        {
+            return std::get<I>(columns_);
+        }
+
+        // Bit i % 64 of word i / 64 is set if row i failed to parse.
+        std::span<const std::uint64_t> error_bitmap() const { return errors_; }
+
+        bool failed(std::size_t row) const
+        {
+            return (errors_[row / 64] >> (row % 64)) & 1;
+        }
+
+        std::size_t error_count() const
+        {
+            std::size_t ret = 0;
+            for (const auto word : errors_)
+            {
+                ret += static_cast<std::size_t>(std::popcount(word));
+            }
+
+            return ret;
+        }
+
+        void reserve(std::size_t rows)
+        {
+            std::apply([&](auto&... c) { (c.reserve(rows), ...); }, columns_);
+            errors_.reserve((rows + 63) / 64);
+        }
+
+        // Adds a row of value initialized elements, for the caller to
+        // parse into.
+        void append_row()
+        {
+            std::apply([](auto&... c) { (c.emplace_back(), ...); }, columns_);
+            if (rows_ % 64 == 0)
+            {
+                errors_.push_back(0);
+            }
+
+            ++rows_;
+        }
+
+        template <std::size_t I>
+        std::tuple_element_t<I, std::tuple<Ts...>>& last()
+        {
+            return std::get<I>(columns_).back();
+        }
+
+        void set_last_failed(bool failed)
+        {
+            const auto row = rows_ - 1;
+            errors_.back() |= std::uint64_t{failed} << (row % 64);
+        }
+
+    private:
+        std::tuple<std::pmr::vector<Ts>...> columns_;
+        std::pmr::vector<std::uint64_t> errors_;
+        std::size_t rows_{0};
+    };
+
+    template <typename Separator, typename... Fields>
+    using record_columns_for =
+        record_columns<parser_parse_type<Fields const&>...>;
+
+    namespace detail
+    {
+        // Parses the fields of a record straight into the last row of out,
+        // each into its column, so no row is ever built and transposed.
+        template <std::size_t I, typename Separator, typename... Fields,
+                  typename Columns>
+        bool parse_record_fields(
+            record_schema<Separator, Fields...> const& schema,
+            parse_cursor& c,
+            Columns& out)
+        {
+            if constexpr (I == sizeof...(Fields))
+            {
+                return c.empty();
+            }
+            else
+            {
+                if constexpr (I > 0)
+                {
+                    const auto r = ptcore::recognize(schema.sep, c.rest());
+                    if (!r)
+                    {
+                        return false;
+                    }
+
+                    c.pos = c.end - r->size();
+                }
+
+                return ptcore::parse_into(std::get<I>(schema.fields), c,
+                                          out.template last<I>()) &&
+                       parse_record_fields<I + 1>(schema, c, out);
+            }
+        }
+    }
+
+    // Parses every newline terminated record of s with schema, appending a
+    // row to out for each. A "\r\n" line end is accepted too, and a final
+    // record needs no newline. Returns the number of rows that failed.
+    template <typename Separator, typename... Fields>
+    std::size_t parse_records(record_schema<Separator, Fields...> const& schema,
+                              parse_input_t s,
+                              record_columns_for<Separator, Fields...>& out)
+    {
+        std::size_t failures = 0;
+        while (!s.empty())
+        {
+            const void* nl = std::memchr(s.data(), '\n', s.size());
+            const std::size_t length =
+                nl ? static_cast<std::size_t>(
+                         static_cast<const char*>(nl) - s.data())
+                   : s.size();
+
+            auto line = s.substr(0, length);
+            s.remove_prefix(nl ? length + 1 : length);
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.remove_suffix(1);
+            }
+
+            out.append_row();
+            parse_cursor c{ line };
+            const bool ok = detail::parse_record_fields<0>(schema, c, out);
+            out.set_last_failed(!ok);
+            failures += !ok;
+        }
+
+        return failures;
+    }
+
+    // Parses the records of s into new columns allocating from mr.
+    template <typename Separator, typename... Fields>
+    record_columns_for<Separator, Fields...> parse_records(
+        record_schema<Separator, Fields...> const& schema,
+        parse_input_t s,
+        std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+    {
+        record_columns_for<Separator, Fields...> ret{ mr };
+        parse_records(schema, s, ret);
+        return ret;
+    }
+}
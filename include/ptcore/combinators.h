@@ -0,0 +1,308 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "ptcore/parser.h"
+
+namespace ptcore
+{
+    namespace detail
+    {
+        template <typename... P>
+        struct seq_parser
+        {
+            using tuple_t = std::tuple<parser_parse_type<P const&>...>;
+
+            constexpr seq_parser(P... ps)
+                : parsers{ std::move(ps)... },
+                  min_length{ info().min_length }
+            {
+            }
+
+            constexpr parse_return_t<tuple_t> operator()(parse_input_t s) const
+            {
+                return parse_via_cursor(*this, s);
+            }
+
+            // Each value is parsed straight into its element of out.
+            constexpr bool parse_into(parse_cursor& c, tuple_t& out) const
+            {
+                if (c.size() < min_length)
+                {
+                    return false;
+                }
+
+                auto next = c;
+                if (!parse_into(next, out, std::index_sequence_for<P...>{}))
+                {
+                    return false;
+                }
+
+                c = next;
+                return true;
+            }
+
+            constexpr recognize_return_t recognize(parse_input_t s) const
+            {
+                if (s.size() < min_length)
+                {
+                    return std::nullopt;
+                }
+
+                recognize_return_t r = s;
+                std::apply(
+                    [&](auto const&... p)
+                    {
+                        ((r = r ? ptcore::recognize(p, *r) : std::nullopt),
+                         ...);
+                    },
+                    parsers);
+
+                return r;
+            }
+
+            constexpr bool incomplete(parse_input_t s) const
+            {
+                sequence_walk w{ s };
+                std::apply([&](auto const&... p) { (w.step(p) && ...); },
+                           parsers);
+                return w.result;
+            }
+
+            constexpr parser_info info() const
+            {
+                return std::apply(
+                    [](auto const&... p)
+                    {
+                        parser_info ret{ char_class{}, 0, 0 };
+                        ((ret = sequence_info(ret, ptcore::info(p))), ...);
+                        return ret;
+                    },
+                    parsers);
+            }
+
+            std::tuple<P...> parsers;
+
+            // input shorter than this cannot match, so it is rejected
+            // before running any parser
+            std::size_t min_length;
+
+        private:
+            template <std::size_t... I>
+            constexpr bool parse_into(parse_cursor& c,
+                                      tuple_t& out,
+                                      std::index_sequence<I...>) const
+            {
+                return (ptcore::parse_into(std::get<I>(parsers), c,
+                                           std::get<I>(out)) &&
+                        ...);
+            }
+        };
+
+        // Bit i of a branch_mask_t<N> stands for the i-th of N branches.
+        template <std::size_t N>
+        using branch_mask_t = std::conditional_t<
+            N <= 8, std::uint8_t,
+            std::conditional_t<
+                N <= 16, std::uint16_t,
+                std::conditional_t<N <= 32, std::uint32_t, std::uint64_t>>>;
+
+        template <typename... Ts>
+        struct alt_value;
+
+        // The value of an alternative: the common type of the branches if
+        // they all produce the same type, otherwise a variant indexed like
+        // the branches.
+        template <typename T, typename... Ts>
+        struct alt_value<T, Ts...>
+        {
+            static constexpr bool common = (std::same_as<T, Ts> && ...);
+
+            using type =
+                std::conditional_t<common, T, std::variant<T, Ts...>>;
+        };
+
+        template <typename... P>
+        struct alt_parser
+        {
+            static constexpr std::size_t branch_count = sizeof...(P);
+
+            using mask_t = branch_mask_t<branch_count>;
+            using value_info = alt_value<parser_parse_type<P const&>...>;
+            using value_t = typename value_info::type;
+
+            constexpr alt_parser(P... ps)
+                : parsers{ std::move(ps)... }
+            {
+                std::apply(
+                    [&](auto const&... p)
+                    {
+                        std::size_t i = 0;
+                        (add_branch(ptcore::info(p), i++), ...);
+                    },
+                    parsers);
+            }
+
+            // Tries, in order, only the branches whose info allows a match
+            // at the front of s. The first one that matches wins.
+            constexpr parse_return_t<value_t> operator()(parse_input_t s) const
+            {
+                return parse(s, viable(s), std::index_sequence_for<P...>{});
+            }
+
+            constexpr recognize_return_t recognize(parse_input_t s) const
+            {
+                return recognize(s, viable(s),
+                                 std::index_sequence_for<P...>{});
+            }
+
+            // Any branch that could still match makes the whole incomplete.
+            constexpr bool incomplete(parse_input_t s) const
+            {
+                return std::apply(
+                    [&](auto const&... p)
+                    { return (ptcore::incomplete(p, s) || ...); },
+                    parsers);
+            }
+
+            constexpr parser_info info() const
+            {
+                return std::apply(
+                    [](auto const&... p)
+                    {
+                        parser_info ret{ char_class{}, parser_info::unbounded,
+                                         0 };
+                        (
+                            [&](parser_info const& branch)
+                            {
+                                ret.first = ret.first | branch.first;
+                                ret.min_length = std::min(ret.min_length,
+                                                          branch.min_length);
+                                ret.max_length = std::max(ret.max_length,
+                                                          branch.max_length);
+                            }(ptcore::info(p)),
+                            ...);
+                        return ret;
+                    },
+                    parsers);
+            }
+
+            std::tuple<P...> parsers;
+
+        private:
+            constexpr void add_branch(parser_info const& branch, std::size_t i)
+            {
+                const auto bit = static_cast<mask_t>(mask_t{1} << i);
+
+                for (std::size_t b = 0; b < table.size(); ++b)
+                {
+                    if (branch.nullable() ||
+                        branch.first.contains(static_cast<char>(b)))
+                    {
+                        table[b] |= bit;
+                    }
+                }
+
+                min_lengths[i] = branch.min_length;
+            }
+
+            constexpr mask_t viable(parse_input_t s) const
+            {
+                mask_t ret = s.empty()
+                                 ? static_cast<mask_t>(~mask_t{0})
+                                 : table[static_cast<unsigned char>(s.front())];
+
+                for (std::size_t i = 0; i < branch_count; ++i)
+                {
+                    if (s.size() < min_lengths[i])
+                    {
+                        ret &= static_cast<mask_t>(~(mask_t{1} << i));
+                    }
+                }
+
+                return ret;
+            }
+
+            template <std::size_t... I>
+            constexpr parse_return_t<value_t> parse(
+                parse_input_t s, mask_t mask, std::index_sequence<I...>) const
+            {
+                parse_return_t<value_t> ret;
+
+                ((((mask >> I) & 1) != 0 && try_branch<I>(s, ret)) || ...);
+
+                return ret;
+            }
+
+            template <std::size_t... I>
+            constexpr recognize_return_t recognize(
+                parse_input_t s, mask_t mask, std::index_sequence<I...>) const
+            {
+                recognize_return_t ret;
+
+                ((((mask >> I) & 1) != 0 &&
+                  (ret = ptcore::recognize(std::get<I>(parsers), s))) ||
+                 ...);
+
+                return ret;
+            }
+
+            template <std::size_t I>
+            constexpr bool try_branch(parse_input_t s,
+                                      parse_return_t<value_t>& ret) const
+            {
+                auto r = std::get<I>(parsers)(s);
+                if (!r)
+                {
+                    return false;
+                }
+
+                if constexpr (value_info::common)
+                {
+                    ret = parse_results{ std::move(r->value),
+                                         r->remaining_input };
+                }
+                else
+                {
+                    ret = parse_results{
+                        value_t{ std::in_place_index<I>, std::move(r->value) },
+                        r->remaining_input };
+                }
+
+                return true;
+            }
+
+            // table[b] has the bits of the branches that can match input
+            // starting with the byte b
+            std::array<mask_t, 256> table{};
+            std::array<std::size_t, branch_count> min_lengths{};
+        };
+    }
+
+    // Matches each of ps in turn, producing a tuple of their values.
+    template <parser... P>
+    requires(sizeof...(P) > 0)
+    constexpr auto seq(P&&... ps)
+    {
+        return detail::seq_parser<std::remove_cvref_t<P>...>{
+            std::forward<P>(ps)... };
+    }
+
+    // Matches the first of ps that matches. Branches that cannot match the
+    // next byte, according to their parser_info, are not tried.
+    template <parser... P>
+    requires(sizeof...(P) > 0 && sizeof...(P) <= 64)
+    constexpr auto alt(P&&... ps)
+    {
+        return detail::alt_parser<std::remove_cvref_t<P>...>{
+            std::forward<P>(ps)... };
+    }
+}
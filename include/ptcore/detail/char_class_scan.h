@@ -0,0 +1,159 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "ptcore/char_class.h"
+#include "ptcore/detail/simd.h"
+
+namespace ptcore::detail
+{
+    // The scans of a char_class over a string, 16 (SSSE3) or 32 (AVX2)
+    // bytes at a time where the CPU allows, and one byte at a time in
+    // constant evaluation.
+    struct char_class_scanner
+    {
+        // The number of leading characters of s whose membership of cls
+        // is member.
+        static constexpr std::size_t scan(char_class const& cls,
+                                          std::string_view s,
+                                          bool member)
+        {
+            if consteval
+            {
+                return scan_scalar(cls, s, 0, member);
+            }
+            else
+            {
+#if PTCORE_SIMD_X86
+                if (s.size() >= 16)
+                {
+                    switch (cpu_simd_level())
+                    {
+                        case simd_level::avx2:
+                            return scan_avx2(cls, s, member);
+                        case simd_level::ssse3:
+                            return scan_ssse3(cls, s, member);
+                        case simd_level::scalar:
+                            break;
+                    }
+                }
+#endif
+                return scan_scalar(cls, s, 0, member);
+            }
+        }
+
+        static constexpr std::size_t scan_scalar(char_class const& cls,
+                                                 std::string_view s,
+                                                 std::size_t i,
+                                                 bool member)
+        {
+            for (; i < s.size(); ++i)
+            {
+                if (cls.contains(s[i]) != member)
+                {
+                    break;
+                }
+            }
+
+            return i;
+        }
+
+#if PTCORE_SIMD_X86
+        PTCORE_TARGET("ssse3")
+        static __m128i classify(__m128i v, __m128i low, __m128i high)
+        {
+            const __m128i nibble = _mm_set1_epi8(0x0f);
+            const __m128i bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128,
+                                               1, 2, 4, 8, 16, 32, 64, -128);
+
+            const __m128i lo = _mm_and_si128(v, nibble);
+            const __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), nibble);
+            const __m128i upper = _mm_cmpgt_epi8(hi, _mm_set1_epi8(7));
+            const __m128i row =
+                _mm_or_si128(_mm_and_si128(upper, _mm_shuffle_epi8(high, lo)),
+                             _mm_andnot_si128(upper, _mm_shuffle_epi8(low, lo)));
+            const __m128i bit = _mm_shuffle_epi8(bits, hi);
+
+            return _mm_cmpeq_epi8(_mm_and_si128(row, bit), bit);
+        }
+
+        PTCORE_TARGET("ssse3")
+        static std::size_t scan_ssse3(char_class const& cls,
+                                      std::string_view s,
+                                      bool member)
+        {
+            const __m128i low = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(cls.low_.data()));
+            const __m128i high = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(cls.high_.data()));
+            const unsigned flip = member ? 0xffffu : 0u;
+
+            std::size_t i = 0;
+            for (; i + 16 <= s.size(); i += 16)
+            {
+                const __m128i v = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(s.data() + i));
+                const unsigned stop = flip ^ static_cast<unsigned>(
+                    _mm_movemask_epi8(classify(v, low, high)));
+                if (stop != 0)
+                {
+                    return i + static_cast<std::size_t>(std::countr_zero(stop));
+                }
+            }
+
+            return scan_scalar(cls, s, i, member);
+        }
+
+        PTCORE_TARGET("avx2")
+        static std::size_t scan_avx2(char_class const& cls,
+                                     std::string_view s,
+                                     bool member)
+        {
+            const __m256i low = _mm256_broadcastsi128_si256(_mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(cls.low_.data())));
+            const __m256i high = _mm256_broadcastsi128_si256(_mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(cls.high_.data())));
+            const __m256i nibble = _mm256_set1_epi8(0x0f);
+            const __m256i bits = _mm256_setr_epi8(
+                1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+                1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+            const std::uint32_t flip = member ? 0xffffffffu : 0u;
+
+            std::size_t i = 0;
+            for (; i + 32 <= s.size(); i += 32)
+            {
+                const __m256i v = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(s.data() + i));
+                const __m256i lo = _mm256_and_si256(v, nibble);
+                const __m256i hi =
+                    _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble);
+                const __m256i upper =
+                    _mm256_cmpgt_epi8(hi, _mm256_set1_epi8(7));
+                const __m256i row = _mm256_blendv_epi8(
+                    _mm256_shuffle_epi8(low, lo),
+                    _mm256_shuffle_epi8(high, lo), upper);
+                const __m256i bit = _mm256_shuffle_epi8(bits, hi);
+                const __m256i in =
+                    _mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit);
+
+                const std::uint32_t stop =
+                    flip ^ static_cast<std::uint32_t>(_mm256_movemask_epi8(in));
+                if (stop != 0)
+                {
+                    return i + static_cast<std::size_t>(std::countr_zero(stop));
+                }
+            }
+
+            if (i < s.size())
+            {
+                return i + scan_ssse3(cls, s.substr(i), member);
+            }
+
+            return i;
+        }
+#endif
+    };
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "ptcore/detail/simd.h"
+
+namespace ptcore::detail
+{
+#if PTCORE_SIMD_X86
+    // Converts s, which must be 1 to 16 bytes long, as a run of decimal
+    // digits without a branch: s is right aligned in a window of '0'
+    // bytes, all 16 bytes are checked at once, and multiply-adds combine
+    // them into pairs, fours and eights of digits. Returns whether s is
+    // all digits; out is unspecified if it is not.
+    PTCORE_TARGET("ssse3")
+    inline bool parse_digit_field(std::string_view s, std::uint64_t& out)
+    {
+        char window[16];
+        std::memset(window, '0', sizeof(window));
+        std::memcpy(window + sizeof(window) - s.size(), s.data(), s.size());
+
+        const __m128i d = _mm_sub_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(window)),
+            _mm_set1_epi8('0'));
+
+        // bytes below '0' wrap around, so this also catches them
+        const bool digits =
+            _mm_movemask_epi8(_mm_cmpeq_epi8(
+                _mm_subs_epu8(d, _mm_set1_epi8(9)), _mm_setzero_si128())) ==
+            0xffff;
+
+        const __m128i pairs = _mm_maddubs_epi16(
+            d, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1,
+                             10, 1, 10, 1, 10, 1, 10, 1));
+        const __m128i fours = _mm_madd_epi16(
+            pairs, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+        const __m128i eights = _mm_madd_epi16(
+            _mm_packs_epi32(fours, fours),
+            _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+
+        const auto high = static_cast<std::uint32_t>(_mm_cvtsi128_si32(eights));
+        const auto low = static_cast<std::uint32_t>(
+            _mm_cvtsi128_si32(_mm_srli_si128(eights, 4)));
+
+        out = std::uint64_t{high} * 100000000 + low;
+        return digits;
+    }
+#endif
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string_view>
+
+#include "ptcore/detail/simd.h"
+#include "ptcore/detail/swar.h"
+
+namespace ptcore::detail
+{
+    enum class kernel_status
+    {
+        matched,
+        failed,
+        fallback
+    };
+
+    struct kernel_result
+    {
+        kernel_status status{kernel_status::fallback};
+        std::size_t length{0};
+    };
+
+#if PTCORE_SIMD_X86
+    // Parses N unsigned digit runs separated by sep from the first 16 bytes
+    // of s in one pass: a single load classifies digits and separators, and
+    // each field is converted with SWAR. Returns fallback when the tuple
+    // does not end inside the window, leaving s to the generic path.
+    template <std::unsigned_integral T, std::size_t N>
+    kernel_result match_digit_tuple(std::string_view s,
+                                    char sep,
+                                    std::array<T, N>& out)
+    {
+        // 8 '0' bytes of padding in front of the window let every field of
+        // up to 8 digits be loaded as one left padded 8 byte word
+        char window[24];
+        std::memset(window, '0', 8);
+
+        const bool truncated = s.size() > 16;
+        if (s.size() >= 16)
+        {
+            std::memcpy(window + 8, s.data(), 16);
+        }
+        else
+        {
+            std::memset(window + 8, 0, 16);
+            std::memcpy(window + 8, s.data(), s.size());
+        }
+
+        const __m128i v =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(window + 8));
+        const __m128i digits =
+            _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)),
+                          _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+
+        // bit 16 is a sentinel so every run ends inside the mask
+        const std::uint32_t non_digits =
+            ~static_cast<std::uint32_t>(_mm_movemask_epi8(digits)) & 0x1ffff;
+        const std::uint32_t in_input =
+            truncated || s.size() == 16 ? 0xffff : (1u << s.size()) - 1;
+        const auto separators =
+            in_input & static_cast<std::uint32_t>(_mm_movemask_epi8(
+                           _mm_cmpeq_epi8(v, _mm_set1_epi8(sep))));
+
+        constexpr std::uint64_t max = std::numeric_limits<T>::max();
+
+        std::size_t pos = 0;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            const auto len =
+                static_cast<std::size_t>(std::countr_zero(non_digits >> pos));
+            if (len == 0)
+            {
+                return { kernel_status::failed };
+            }
+
+            if (truncated && pos + len == 16)
+            {
+                return { kernel_status::fallback };
+            }
+
+            std::uint64_t value = 0;
+            if (len <= 8)
+            {
+                const auto pad = (8 - len) * 8;
+                const std::uint64_t pad_mask = (std::uint64_t{1} << pad) - 1;
+                const auto word =
+                    (load_eight_bytes(window + pos + len) & ~pad_mask) |
+                    (0x3030303030303030 & pad_mask);
+                value = parse_eight_digits(word);
+            }
+            else
+            {
+                const auto r = parse_digits(
+                    std::string_view{ window + 8 + pos, len }, max);
+                if (r.overflow)
+                {
+                    return { kernel_status::failed };
+                }
+                value = r.value;
+            }
+
+            if (value > max)
+            {
+                return { kernel_status::failed };
+            }
+
+            out[i] = static_cast<T>(value);
+            pos += len;
+
+            if (i + 1 < N)
+            {
+                if (((separators >> pos) & 1) == 0)
+                {
+                    return { kernel_status::failed };
+                }
+
+                ++pos;
+                if (truncated && pos == 16)
+                {
+                    return { kernel_status::fallback };
+                }
+            }
+        }
+
+        return { kernel_status::matched, pos };
+    }
+#endif
+}
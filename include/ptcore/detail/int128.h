@@ -0,0 +1,189 @@
+#pragma once
+
+#include <compare>
+#include <concepts>
+#include <cstdint>
+
+#if !defined(PTCORE_NO_INT128) && defined(__SIZEOF_INT128__)
+#define PTCORE_INT128 1
+#else
+#define PTCORE_INT128 0
+#endif
+
+namespace ptcore::detail
+{
+    struct value128
+    {
+        std::uint64_t low{0};
+        std::uint64_t high{0};
+    };
+
+    constexpr value128 full_multiplication(std::uint64_t a, std::uint64_t b)
+    {
+#if PTCORE_INT128
+        const auto r = static_cast<unsigned __int128>(a) * b;
+        return { static_cast<std::uint64_t>(r),
+                 static_cast<std::uint64_t>(r >> 64) };
+#else
+        const std::uint64_t a_lo = a & 0xffffffff;
+        const std::uint64_t a_hi = a >> 32;
+        const std::uint64_t b_lo = b & 0xffffffff;
+        const std::uint64_t b_hi = b >> 32;
+
+        const std::uint64_t lo_lo = a_lo * b_lo;
+        const std::uint64_t hi_lo = a_hi * b_lo;
+        const std::uint64_t lo_hi = a_lo * b_hi;
+        const std::uint64_t hi_hi = a_hi * b_hi;
+
+        const std::uint64_t cross =
+            (lo_lo >> 32) + (hi_lo & 0xffffffff) + lo_hi;
+
+        return { (cross << 32) | (lo_lo & 0xffffffff),
+                 (hi_lo >> 32) + (cross >> 32) + hi_hi };
+#endif
+    }
+
+    // A signed 128 bit integer in two's complement, for compilers without
+    // __int128, with the arithmetic and comparisons of one. Like the
+    // built in types, it wraps on overflow, which callers keep clear of,
+    // and division truncates toward zero.
+    class int128
+    {
+    public:
+        constexpr int128() = default;
+
+        template <std::signed_integral T>
+        constexpr int128(T v)
+            : low_{ static_cast<std::uint64_t>(v) },
+              high_{ v < 0 ? ~std::uint64_t{0} : 0 }
+        {
+        }
+
+        template <std::unsigned_integral T>
+        constexpr int128(T v) : low_{ v }
+        {
+        }
+
+        template <std::integral T>
+        constexpr explicit operator T() const
+        {
+            return static_cast<T>(low_);
+        }
+
+        friend constexpr bool operator==(int128, int128) = default;
+
+        friend constexpr std::strong_ordering operator<=>(int128 a, int128 b)
+        {
+            if (a.high_ != b.high_)
+            {
+                return static_cast<std::int64_t>(a.high_) <=>
+                       static_cast<std::int64_t>(b.high_);
+            }
+
+            return a.low_ <=> b.low_;
+        }
+
+        constexpr int128 operator-() const
+        {
+            return make(~low_ + 1, ~high_ + (low_ == 0 ? 1 : 0));
+        }
+
+        friend constexpr int128 operator+(int128 a, int128 b)
+        {
+            const std::uint64_t low = a.low_ + b.low_;
+            return make(low, a.high_ + b.high_ + (low < a.low_ ? 1 : 0));
+        }
+
+        friend constexpr int128 operator-(int128 a, int128 b)
+        {
+            return a + -b;
+        }
+
+        friend constexpr int128 operator*(int128 a, int128 b)
+        {
+            const auto p = full_multiplication(a.low_, b.low_);
+            return make(p.low,
+                        p.high + a.low_ * b.high_ + a.high_ * b.low_);
+        }
+
+        friend constexpr int128 operator/(int128 a, int128 b)
+        {
+            int128 r;
+            return divide(a, b, r);
+        }
+
+        friend constexpr int128 operator%(int128 a, int128 b)
+        {
+            int128 r;
+            divide(a, b, r);
+            return r;
+        }
+
+    private:
+        static constexpr int128 make(std::uint64_t low, std::uint64_t high)
+        {
+            int128 ret;
+            ret.low_ = low;
+            ret.high_ = high;
+            return ret;
+        }
+
+        static constexpr int128 divide(int128 a, int128 b, int128& r)
+        {
+            const bool a_negative = a < 0;
+            const bool b_negative = b < 0;
+            const int128 q = divide_unsigned(a_negative ? -a : a,
+                                             b_negative ? -b : b, r);
+            if (a_negative)
+            {
+                r = -r;
+            }
+
+            return a_negative != b_negative ? -q : q;
+        }
+
+        // n / d and n % d of the bit patterns as unsigned values, one bit
+        // of the quotient at a time unless both fit in 64 bits. Neither
+        // is above 2^127, so the partial remainder never overflows.
+        static constexpr int128 divide_unsigned(int128 n,
+                                                int128 d,
+                                                int128& r)
+        {
+            if (n.high_ == 0 && d.high_ == 0)
+            {
+                r = make(n.low_ % d.low_, 0);
+                return make(n.low_ / d.low_, 0);
+            }
+
+            int128 q;
+            r = {};
+            for (int i = 127; i >= 0; --i)
+            {
+                const std::uint64_t bit =
+                    (i >= 64 ? n.high_ >> (i - 64) : n.low_ >> i) & 1;
+                r = make((r.low_ << 1) | bit,
+                         (r.high_ << 1) | (r.low_ >> 63));
+
+                const bool fits = r.high_ != d.high_ ? r.high_ > d.high_
+                                                     : r.low_ >= d.low_;
+                if (fits)
+                {
+                    r = r - d;
+                    if (i >= 64)
+                    {
+                        q.high_ |= std::uint64_t{1} << (i - 64);
+                    }
+                    else
+                    {
+                        q.low_ |= std::uint64_t{1} << i;
+                    }
+                }
+            }
+
+            return q;
+        }
+
+        std::uint64_t low_{0};
+        std::uint64_t high_{0};
+    };
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if !defined(PTCORE_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64))
+#define PTCORE_SIMD_X86 1
+#else
+#define PTCORE_SIMD_X86 0
+#endif
+
+#if PTCORE_SIMD_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang only emit instructions above the baseline ISA inside
+// functions that opt in to them; MSVC allows the intrinsics everywhere.
+#if PTCORE_SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+#define PTCORE_TARGET(isa) __attribute__((target(isa)))
+#else
+#define PTCORE_TARGET(isa)
+#endif
+
+namespace ptcore::detail
+{
+    enum class simd_level
+    {
+        scalar,
+        ssse3,
+        avx2
+    };
+
+    inline simd_level detect_simd_level() noexcept
+    {
+#if PTCORE_SIMD_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4]{};
+        __cpuid(info, 0);
+        const int max_leaf = info[0];
+
+        __cpuid(info, 1);
+        const bool ssse3 = (info[2] & (1 << 9)) != 0;
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+
+        bool avx2 = false;
+        if (max_leaf >= 7 && osxsave && avx &&
+            (_xgetbv(0) & 0x6) == 0x6)
+        {
+            __cpuidex(info, 7, 0);
+            avx2 = (info[1] & (1 << 5)) != 0;
+        }
+#else
+        __builtin_cpu_init();
+        const bool ssse3 = __builtin_cpu_supports("ssse3");
+        const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+        if (avx2)
+        {
+            return simd_level::avx2;
+        }
+
+        if (ssse3)
+        {
+            return simd_level::ssse3;
+        }
+#endif
+        return simd_level::scalar;
+    }
+
+    inline simd_level cpu_simd_level() noexcept
+    {
+        static const simd_level level = detect_simd_level();
+        return level;
+    }
+
+    // Starts loading the cache line at p, for data that is needed soon.
+    inline void prefetch(const void* p) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(p);
+#elif PTCORE_SIMD_X86
+        _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+        (void)p;
+#endif
+    }
+
+#if PTCORE_SIMD_X86
+    PTCORE_TARGET("avx2")
+    inline std::uint64_t eq_mask64_avx2(const char* p, char c) noexcept
+    {
+        const __m256i needle = _mm256_set1_epi8(c);
+        const auto lo = static_cast<std::uint32_t>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)),
+                needle)));
+        const auto hi = static_cast<std::uint32_t>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32)),
+                needle)));
+        return (std::uint64_t{hi} << 32) | lo;
+    }
+
+    inline std::uint64_t eq_mask64_sse2(const char* p, char c) noexcept
+    {
+        const __m128i needle = _mm_set1_epi8(c);
+        std::uint64_t ret = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            const __m128i v =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+            ret |= std::uint64_t{static_cast<std::uint16_t>(
+                       _mm_movemask_epi8(_mm_cmpeq_epi8(v, needle)))}
+                   << (16 * i);
+        }
+        return ret;
+    }
+#endif
+
+    // Bit i is set when p[i] == c, for the 64 bytes starting at p.
+    inline std::uint64_t eq_mask64(const char* p, char c) noexcept
+    {
+#if PTCORE_SIMD_X86
+        if (cpu_simd_level() == simd_level::avx2)
+        {
+            return eq_mask64_avx2(p, c);
+        }
+        return eq_mask64_sse2(p, c);
+#else
+        std::uint64_t ret = 0;
+        for (std::size_t i = 0; i < 64; ++i)
+        {
+            ret |= std::uint64_t{p[i] == c} << i;
+        }
+        return ret;
+#endif
+    }
+}
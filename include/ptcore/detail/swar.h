@@ -0,0 +1,138 @@
+#pragma once
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace ptcore::detail
+{
+    constexpr bool is_digit(char ch)
+    {
+        return ch >= '0' && ch <= '9';
+    }
+
+    // Little endian load of sizeof(W) bytes; p must have that many
+    // readable bytes.
+    template <std::unsigned_integral W>
+    constexpr W load_word(const char* p)
+    {
+        if consteval
+        {
+            W ret = 0;
+            for (auto i = static_cast<int>(sizeof(W)) - 1; i >= 0; --i)
+            {
+                ret = static_cast<W>((ret << 8) |
+                                     static_cast<unsigned char>(p[i]));
+            }
+            return ret;
+        }
+        else
+        {
+            W ret;
+            std::memcpy(&ret, p, sizeof(ret));
+            if constexpr (std::endian::native == std::endian::big)
+            {
+                ret = std::byteswap(ret);
+            }
+            return ret;
+        }
+    }
+
+    // Little endian load of 8 bytes; p must have at least 8 readable
+    // bytes.
+    constexpr std::uint64_t load_eight_bytes(const char* p)
+    {
+        return load_word<std::uint64_t>(p);
+    }
+
+    constexpr bool is_eight_digits(std::uint64_t v)
+    {
+        return (((v & 0xf0f0f0f0f0f0f0f0) |
+                 (((v + 0x0606060606060606) & 0xf0f0f0f0f0f0f0f0) >> 4)) ==
+                0x3333333333333333);
+    }
+
+    // SWAR conversion of 8 ASCII digits, first digit in the low byte.
+    constexpr std::uint32_t parse_eight_digits(std::uint64_t v)
+    {
+        constexpr std::uint64_t mask = 0x000000ff000000ff;
+        constexpr std::uint64_t mul1 = 100 + (1000000ull << 32);
+        constexpr std::uint64_t mul2 = 1 + (10000ull << 32);
+
+        v -= 0x3030303030303030;
+        v = (v * 10) + (v >> 8);
+        v = (((v & mask) * mul1) + (((v >> 16) & mask) * mul2)) >> 32;
+        return static_cast<std::uint32_t>(v);
+    }
+
+    // Length of the leading run of digits of s.
+    constexpr std::size_t count_digits(std::string_view s)
+    {
+        std::size_t i = 0;
+        while (i + 8 <= s.size() &&
+               is_eight_digits(load_eight_bytes(s.data() + i)))
+        {
+            i += 8;
+        }
+
+        while (i < s.size() && is_digit(s[i]))
+        {
+            ++i;
+        }
+
+        return i;
+    }
+
+    struct digits_result
+    {
+        std::uint64_t value{0};
+        std::size_t length{0};
+        bool overflow{false};
+    };
+
+    // Accumulates the leading run of digits of s, stopping (with
+    // overflow set) as soon as the value would exceed max.
+    constexpr digits_result parse_digits(std::string_view s,
+                                         std::uint64_t max)
+    {
+        digits_result ret;
+        auto& v = ret.value;
+        auto& i = ret.length;
+
+        while (i + 8 <= s.size())
+        {
+            const auto chunk = load_eight_bytes(s.data() + i);
+            if (!is_eight_digits(chunk))
+            {
+                break;
+            }
+
+            const auto eight = parse_eight_digits(chunk);
+            if (eight > max || v > (max - eight) / 100000000)
+            {
+                ret.overflow = true;
+                return ret;
+            }
+
+            v = v * 100000000 + eight;
+            i += 8;
+        }
+
+        for (; i < s.size() && is_digit(s[i]); ++i)
+        {
+            const auto d = static_cast<std::uint64_t>(s[i] - '0');
+            if (v > (max - d) / 10)
+            {
+                ret.overflow = true;
+                return ret;
+            }
+
+            v = v * 10 + d;
+        }
+
+        return ret;
+    }
+}
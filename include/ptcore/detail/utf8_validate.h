@@ -0,0 +1,339 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "ptcore/detail/simd.h"
+#include "ptcore/detail/swar.h"
+
+namespace ptcore::detail
+{
+    // The length of the valid UTF-8 sequence at the front of s, or 0 if
+    // there is none: overlong forms, surrogates, code points above
+    // U+10FFFF and truncated sequences are all invalid.
+    constexpr std::size_t utf8_sequence_length(std::string_view s)
+    {
+        if (s.empty())
+        {
+            return 0;
+        }
+
+        const auto b0 = static_cast<unsigned char>(s[0]);
+        if (b0 < 0x80)
+        {
+            return 1;
+        }
+
+        std::size_t length;
+        unsigned char low = 0x80;
+        unsigned char high = 0xbf;
+        if (b0 >= 0xc2 && b0 <= 0xdf)
+        {
+            length = 2;
+        }
+        else if (b0 >= 0xe0 && b0 <= 0xef)
+        {
+            length = 3;
+            low = b0 == 0xe0 ? 0xa0 : 0x80;
+            high = b0 == 0xed ? 0x9f : 0xbf;
+        }
+        else if (b0 >= 0xf0 && b0 <= 0xf4)
+        {
+            length = 4;
+            low = b0 == 0xf0 ? 0x90 : 0x80;
+            high = b0 == 0xf4 ? 0x8f : 0xbf;
+        }
+        else
+        {
+            return 0;
+        }
+
+        if (s.size() < length)
+        {
+            return 0;
+        }
+
+        const auto b1 = static_cast<unsigned char>(s[1]);
+        if (b1 < low || b1 > high)
+        {
+            return 0;
+        }
+
+        for (std::size_t i = 2; i < length; ++i)
+        {
+            if ((static_cast<unsigned char>(s[i]) & 0xc0) != 0x80)
+            {
+                return 0;
+            }
+        }
+
+        return length;
+    }
+
+    // The length of the longest valid prefix of s, given that s[0, i)
+    // passed the SIMD checks, which leaves unchecked only whether a
+    // sequence that starts in the last three bytes before i is complete.
+    // ASCII is skipped eight bytes at a time.
+    constexpr std::size_t validate_utf8_scalar(std::string_view s,
+                                               std::size_t i)
+    {
+        for (std::size_t back = 1; back <= 3 && back <= i; ++back)
+        {
+            if (static_cast<unsigned char>(s[i - back]) >= 0xc0)
+            {
+                i -= back;
+                break;
+            }
+        }
+
+        while (i < s.size())
+        {
+            if (i + 8 <= s.size() &&
+                (load_eight_bytes(s.data() + i) & 0x8080808080808080) == 0)
+            {
+                i += 8;
+                continue;
+            }
+
+            const auto n = utf8_sequence_length(s.substr(i));
+            if (n == 0)
+            {
+                break;
+            }
+
+            i += n;
+        }
+
+        return i;
+    }
+
+#if PTCORE_SIMD_X86
+    // The lookup tables of the Keiser-Lemire validator ("Validating UTF-8
+    // in less than one instruction per byte", 2021). Each error a pair of
+    // bytes can have is a bit; the tables indexed by the high and low
+    // nibble of the first byte and the high nibble of the second give
+    // the errors each allows, and the pair has an error when all three
+    // agree. Missing continuation bytes after a three or four byte lead
+    // are checked separately.
+    namespace utf8_tables
+    {
+        inline constexpr std::uint8_t too_short = 1 << 0;
+        inline constexpr std::uint8_t too_long = 1 << 1;
+        inline constexpr std::uint8_t overlong_3 = 1 << 2;
+        inline constexpr std::uint8_t too_large = 1 << 3;
+        inline constexpr std::uint8_t surrogate = 1 << 4;
+        inline constexpr std::uint8_t overlong_2 = 1 << 5;
+        inline constexpr std::uint8_t too_large_1000 = 1 << 6;
+        inline constexpr std::uint8_t overlong_4 = 1 << 6;
+        inline constexpr std::uint8_t two_conts = 1 << 7;
+        inline constexpr std::uint8_t carry = too_short | too_long | two_conts;
+
+        alignas(16) inline constexpr std::array<std::uint8_t, 16>
+            byte_1_high{
+                // ASCII
+                too_long, too_long, too_long, too_long,
+                too_long, too_long, too_long, too_long,
+                // continuation
+                two_conts, two_conts, two_conts, two_conts,
+                // 1100____, 1101____
+                too_short | overlong_2,
+                too_short,
+                // 1110____
+                too_short | overlong_3 | surrogate,
+                // 1111____
+                too_short | too_large | too_large_1000 | overlong_4
+            };
+
+        alignas(16) inline constexpr std::array<std::uint8_t, 16>
+            byte_1_low{
+                carry | overlong_3 | overlong_2 | overlong_4,
+                carry | overlong_2,
+                carry,
+                carry,
+                carry | too_large,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000 | surrogate,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000
+            };
+
+        alignas(16) inline constexpr std::array<std::uint8_t, 16>
+            byte_2_high{
+                // ASCII
+                too_short, too_short, too_short, too_short,
+                too_short, too_short, too_short, too_short,
+                // 1000____
+                too_long | overlong_2 | two_conts | overlong_3 |
+                    too_large_1000 | overlong_4,
+                // 1001____
+                too_long | overlong_2 | two_conts | overlong_3 | too_large,
+                // 101_____
+                too_long | overlong_2 | two_conts | surrogate | too_large,
+                too_long | overlong_2 | two_conts | surrogate | too_large,
+                // lead
+                too_short, too_short, too_short, too_short
+            };
+
+        // bytes above these, at the end of a block, start a sequence that
+        // continues in the next block
+        alignas(16) inline constexpr std::array<std::uint8_t, 16>
+            incomplete_above{
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xef, 0xdf, 0xbf
+            };
+    }
+
+    PTCORE_TARGET("ssse3")
+    inline __m128i utf8_table_ssse3(std::array<std::uint8_t, 16> const& t)
+    {
+        return _mm_load_si128(reinterpret_cast<const __m128i*>(t.data()));
+    }
+
+    // The errors of the 16 bytes of input, which follow prev.
+    PTCORE_TARGET("ssse3")
+    inline __m128i utf8_errors_ssse3(__m128i input, __m128i prev)
+    {
+        using namespace utf8_tables;
+
+        const __m128i nibble = _mm_set1_epi8(0x0f);
+        const __m128i prev1 = _mm_alignr_epi8(input, prev, 15);
+        const __m128i prev2 = _mm_alignr_epi8(input, prev, 14);
+        const __m128i prev3 = _mm_alignr_epi8(input, prev, 13);
+
+        const __m128i special = _mm_and_si128(
+            _mm_and_si128(
+                _mm_shuffle_epi8(
+                    utf8_table_ssse3(byte_1_high),
+                    _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+                _mm_shuffle_epi8(utf8_table_ssse3(byte_1_low),
+                                 _mm_and_si128(prev1, nibble))),
+            _mm_shuffle_epi8(
+                utf8_table_ssse3(byte_2_high),
+                _mm_and_si128(_mm_srli_epi16(input, 4), nibble)));
+
+        // the second byte after a three or four byte lead, and the third
+        // after a four byte lead, must be continuations
+        const __m128i must_continue = _mm_and_si128(
+            _mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8(0x60)),
+                         _mm_subs_epu8(prev3, _mm_set1_epi8(0x70))),
+            _mm_set1_epi8(static_cast<char>(0x80)));
+
+        return _mm_xor_si128(must_continue, special);
+    }
+
+    // The length of the longest valid prefix of s, 16 bytes at a time.
+    // A block of ASCII only needs checking for a sequence cut short by
+    // the block before.
+    PTCORE_TARGET("ssse3")
+    inline std::size_t validate_utf8_ssse3(std::string_view s)
+    {
+        const __m128i incomplete_above =
+            utf8_table_ssse3(utf8_tables::incomplete_above);
+
+        __m128i prev = _mm_setzero_si128();
+        __m128i incomplete = _mm_setzero_si128();
+
+        std::size_t i = 0;
+        for (; i + 16 <= s.size(); i += 16)
+        {
+            const __m128i input = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(s.data() + i));
+
+            const __m128i errors =
+                _mm_movemask_epi8(input) == 0
+                    ? incomplete
+                    : utf8_errors_ssse3(input, prev);
+            if (_mm_movemask_epi8(
+                    _mm_cmpeq_epi8(errors, _mm_setzero_si128())) != 0xffff)
+            {
+                break;
+            }
+
+            incomplete = _mm_subs_epu8(input, incomplete_above);
+            prev = input;
+        }
+
+        return validate_utf8_scalar(s, i);
+    }
+
+    PTCORE_TARGET("avx2")
+    inline __m256i utf8_table_avx2(std::array<std::uint8_t, 16> const& t)
+    {
+        return _mm256_broadcastsi128_si256(
+            _mm_load_si128(reinterpret_cast<const __m128i*>(t.data())));
+    }
+
+    PTCORE_TARGET("avx2")
+    inline __m256i utf8_errors_avx2(__m256i input, __m256i prev)
+    {
+        using namespace utf8_tables;
+
+        // alignr works within 128 bit lanes, so it is given the input
+        // shifted by a whole lane
+        const __m256i shifted = _mm256_permute2x128_si256(prev, input, 0x21);
+        const __m256i nibble = _mm256_set1_epi8(0x0f);
+        const __m256i prev1 = _mm256_alignr_epi8(input, shifted, 15);
+        const __m256i prev2 = _mm256_alignr_epi8(input, shifted, 14);
+        const __m256i prev3 = _mm256_alignr_epi8(input, shifted, 13);
+
+        const __m256i special = _mm256_and_si256(
+            _mm256_and_si256(
+                _mm256_shuffle_epi8(
+                    utf8_table_avx2(byte_1_high),
+                    _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+                _mm256_shuffle_epi8(utf8_table_avx2(byte_1_low),
+                                    _mm256_and_si256(prev1, nibble))),
+            _mm256_shuffle_epi8(
+                utf8_table_avx2(byte_2_high),
+                _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble)));
+
+        const __m256i must_continue = _mm256_and_si256(
+            _mm256_or_si256(_mm256_subs_epu8(prev2, _mm256_set1_epi8(0x60)),
+                            _mm256_subs_epu8(prev3, _mm256_set1_epi8(0x70))),
+            _mm256_set1_epi8(static_cast<char>(0x80)));
+
+        return _mm256_xor_si256(must_continue, special);
+    }
+
+    PTCORE_TARGET("avx2")
+    inline std::size_t validate_utf8_avx2(std::string_view s)
+    {
+        const __m256i incomplete_above = _mm256_inserti128_si256(
+            _mm256_set1_epi8(static_cast<char>(0xff)),
+            utf8_table_ssse3(utf8_tables::incomplete_above), 1);
+
+        __m256i prev = _mm256_setzero_si256();
+        __m256i incomplete = _mm256_setzero_si256();
+
+        std::size_t i = 0;
+        for (; i + 32 <= s.size(); i += 32)
+        {
+            const __m256i input = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(s.data() + i));
+
+            const __m256i errors =
+                _mm256_movemask_epi8(input) == 0
+                    ? incomplete
+                    : utf8_errors_avx2(input, prev);
+            if (!_mm256_testz_si256(errors, errors))
+            {
+                break;
+            }
+
+            incomplete = _mm256_subs_epu8(input, incomplete_above);
+            prev = input;
+        }
+
+        return validate_utf8_scalar(s, i);
+    }
+#endif
+}
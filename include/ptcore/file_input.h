@@ -0,0 +1,276 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "ptcore/parser.h"
+
+#if __has_include(<sys/mman.h>) && __has_include(<unistd.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define PTCORE_HAS_MMAP 1
+#else
+#include <cstdio>
+#define PTCORE_HAS_MMAP 0
+#endif
+
+namespace ptcore
+{
+    struct map_options
+    {
+        // ask for transparent huge pages, where the system supports them
+        // for file mappings
+        bool huge_pages{false};
+    };
+
+    // The contents of a file as a parse_input_t. Regular files are mapped
+    // read only, so parsing them copies nothing; other sources, such as
+    // pipes, are read into a buffer. Errors throw std::system_error.
+    class mapped_file
+    {
+    public:
+        mapped_file() = default;
+
+        explicit mapped_file(std::filesystem::path const& path,
+                             map_options opts = {})
+        {
+#if PTCORE_HAS_MMAP
+            const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+            {
+                throw_errno("open", path);
+            }
+
+            try
+            {
+                load(fd, opts);
+            }
+            catch (...)
+            {
+                ::close(fd);
+                throw;
+            }
+
+            ::close(fd);
+#else
+            (void)opts;
+            std::FILE* f = std::fopen(path.string().c_str(), "rb");
+            if (f == nullptr)
+            {
+                throw_errno("open", path);
+            }
+
+            char block[1 << 16];
+            std::size_t n;
+            while ((n = std::fread(block, 1, sizeof(block), f)) > 0)
+            {
+                buffer_.insert(buffer_.end(), block, block + n);
+            }
+
+            const bool failed = std::ferror(f) != 0;
+            std::fclose(f);
+            if (failed)
+            {
+                throw_errno("read", path);
+            }
+
+            data_ = buffer_.data();
+            size_ = buffer_.size();
+#endif
+        }
+
+#if PTCORE_HAS_MMAP
+        // Maps or reads what is left of an open file descriptor, which
+        // stays open and owned by the caller.
+        explicit mapped_file(int fd, map_options opts = {})
+        {
+            load(fd, opts);
+        }
+#endif
+
+        mapped_file(mapped_file&& other) noexcept
+            : data_{ std::exchange(other.data_, nullptr) },
+              size_{ std::exchange(other.size_, 0) },
+              mapped_{ std::exchange(other.mapped_, false) },
+              buffer_{ std::move(other.buffer_) }
+        {
+        }
+
+        mapped_file& operator=(mapped_file&& other) noexcept
+        {
+            if (this != &other)
+            {
+                unmap();
+                data_ = std::exchange(other.data_, nullptr);
+                size_ = std::exchange(other.size_, 0);
+                mapped_ = std::exchange(other.mapped_, false);
+                buffer_ = std::move(other.buffer_);
+            }
+
+            return *this;
+        }
+
+        ~mapped_file() { unmap(); }
+
+        parse_input_t contents() const { return { data_, size_ }; }
+
+        std::size_t size() const { return size_; }
+
+        // Whether the contents are a mapping of the file rather than a
+        // copy of it.
+        bool is_mapped() const { return mapped_; }
+
+    private:
+        [[noreturn]] static void throw_errno(
+            const char* what, std::filesystem::path const& path = {})
+        {
+            // errno first, before building the message can change it
+            const int error = errno;
+
+            std::string message{ what };
+            if (!path.empty())
+            {
+                message += ' ';
+                message += path.string();
+            }
+
+            throw std::system_error{ error, std::generic_category(), message };
+        }
+
+#if PTCORE_HAS_MMAP
+        void load(int fd, map_options opts)
+        {
+            struct stat st;
+            if (::fstat(fd, &st) != 0)
+            {
+                throw_errno("fstat");
+            }
+
+            // an empty file cannot be mapped, and a descriptor that is not
+            // at the start of the file is read from where it is
+            if (S_ISREG(st.st_mode) && st.st_size > 0 &&
+                ::lseek(fd, 0, SEEK_CUR) == 0 &&
+                map(fd, static_cast<std::size_t>(st.st_size), opts))
+            {
+                return;
+            }
+
+            read_all(fd);
+        }
+
+        bool map(int fd, std::size_t size, map_options opts)
+        {
+            void* p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED)
+            {
+                return false;
+            }
+
+            // the parse is one forward pass, so read ahead aggressively
+            // and start the reads now
+            ::madvise(p, size, MADV_SEQUENTIAL);
+            ::madvise(p, size, MADV_WILLNEED);
+#ifdef MADV_HUGEPAGE
+            if (opts.huge_pages)
+            {
+                ::madvise(p, size, MADV_HUGEPAGE);
+            }
+#else
+            (void)opts;
+#endif
+
+            data_ = static_cast<const char*>(p);
+            size_ = size;
+            mapped_ = true;
+            return true;
+        }
+
+        void read_all(int fd)
+        {
+            std::size_t used = 0;
+            buffer_.resize(std::size_t{1} << 16);
+
+            for (;;)
+            {
+                if (used == buffer_.size())
+                {
+                    buffer_.resize(buffer_.size() * 2);
+                }
+
+                const auto n =
+                    ::read(fd, buffer_.data() + used, buffer_.size() - used);
+                if (n == 0)
+                {
+                    break;
+                }
+
+                if (n < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+
+                    throw_errno("read");
+                }
+
+                used += static_cast<std::size_t>(n);
+            }
+
+            buffer_.resize(used);
+            buffer_.shrink_to_fit();
+            data_ = buffer_.data();
+            size_ = buffer_.size();
+        }
+#endif
+
+        void unmap()
+        {
+#if PTCORE_HAS_MMAP
+            if (mapped_)
+            {
+                ::munmap(const_cast<char*>(data_), size_);
+            }
+#endif
+            data_ = nullptr;
+            size_ = 0;
+            mapped_ = false;
+        }
+
+        const char* data_{nullptr};
+        std::size_t size_{0};
+        bool mapped_{false};
+
+        // a std::vector keeps its data pointer when moved, unlike a short
+        // std::string
+        std::vector<char> buffer_;
+    };
+
+    // The result of parsing a file, together with the file, which the
+    // value may refer to.
+    template <typename T>
+    struct file_parse_result
+    {
+        mapped_file file;
+        parse_return_t<T> result;
+    };
+
+    // Runs p once over the whole contents of the file at path, for
+    // instance p = match_entirety(...).
+    template <parser P>
+    file_parse_result<parser_parse_type<P>> parse_file(
+        std::filesystem::path const& path, P&& p, map_options opts = {})
+    {
+        file_parse_result<parser_parse_type<P>> ret{
+            mapped_file{ path, opts }, std::nullopt };
+        ret.result = p(ret.file.contents());
+        return ret;
+    }
+}
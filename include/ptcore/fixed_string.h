@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace ptcore
+{
+    // A string that can be a template argument, e.g. lit<"->">. Its text
+    // is part of the type, so code specialized on it sees the characters
+    // as constants.
+    template <std::size_t N>
+    struct fixed_string
+    {
+        constexpr fixed_string(const char (&s)[N + 1])
+        {
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                chars[i] = s[i];
+            }
+        }
+
+        static constexpr std::size_t size() { return N; }
+
+        constexpr const char* data() const { return chars; }
+
+        constexpr std::string_view view() const { return { chars, N }; }
+
+        constexpr char operator[](std::size_t i) const { return chars[i]; }
+
+        template <std::size_t M>
+        constexpr bool operator==(fixed_string<M> const& other) const
+        {
+            return view() == other.view();
+        }
+
+        // null terminated; public so the type is structural
+        char chars[N + 1]{};
+    };
+
+    template <std::size_t N>
+    fixed_string(const char (&)[N]) -> fixed_string<N - 1>;
+}
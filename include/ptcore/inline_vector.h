@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+
+namespace ptcore
+{
+    // A vector with a fixed capacity and inline storage, so collecting
+    // parsed values never allocates. Like match_n's std::array, every slot
+    // is value-initialized up front, which requires T to be default
+    // constructible.
+    template <typename T, std::size_t Capacity>
+    requires std::is_default_constructible_v<T>
+    class inline_vector
+    {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using reference = T&;
+        using const_reference = T const&;
+        using iterator = T*;
+        using const_iterator = T const*;
+
+        constexpr inline_vector() = default;
+
+        constexpr inline_vector(std::initializer_list<T> values)
+        {
+            for (auto const& v : values)
+            {
+                push_back(v);
+            }
+        }
+
+        static constexpr size_type capacity() { return Capacity; }
+
+        constexpr size_type size() const { return size_; }
+        constexpr bool empty() const { return size_ == 0; }
+        constexpr bool full() const { return size_ == Capacity; }
+
+        // Precondition: !full()
+        constexpr void push_back(T value)
+        {
+            data_[size_++] = std::move(value);
+        }
+
+        constexpr void pop_back() { --size_; }
+        constexpr void clear() { size_ = 0; }
+
+        constexpr reference operator[](size_type i) { return data_[i]; }
+        constexpr const_reference operator[](size_type i) const
+        {
+            return data_[i];
+        }
+
+        constexpr reference front() { return data_[0]; }
+        constexpr const_reference front() const { return data_[0]; }
+        constexpr reference back() { return data_[size_ - 1]; }
+        constexpr const_reference back() const { return data_[size_ - 1]; }
+
+        constexpr T* data() { return data_.data(); }
+        constexpr T const* data() const { return data_.data(); }
+
+        constexpr iterator begin() { return data_.data(); }
+        constexpr const_iterator begin() const { return data_.data(); }
+        constexpr iterator end() { return data_.data() + size_; }
+        constexpr const_iterator end() const { return data_.data() + size_; }
+
+        friend constexpr bool operator==(inline_vector const& lhs,
+                                         inline_vector const& rhs)
+        {
+            if (lhs.size_ != rhs.size_)
+            {
+                return false;
+            }
+
+            for (size_type i = 0; i < lhs.size_; ++i)
+            {
+                if (!(lhs.data_[i] == rhs.data_[i]))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+    private:
+        std::array<T, Capacity> data_{};
+        size_type size_{0};
+    };
+}
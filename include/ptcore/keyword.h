@@ -0,0 +1,375 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "ptcore/parser.h"
+#include "ptcore/char_parsers.h"
+#include "ptcore/detail/swar.h"
+
+namespace ptcore
+{
+    template <typename T>
+    struct keyword_entry
+    {
+        std::string_view text;
+        T value;
+    };
+
+    namespace detail
+    {
+        // The murmur3 finalizer: every input bit affects every output bit.
+        constexpr std::uint64_t mix_bits(std::uint64_t h)
+        {
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccd;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53;
+            h ^= h >> 33;
+            return h;
+        }
+
+        constexpr std::uint64_t keyword_hash(std::string_view s)
+        {
+            constexpr std::uint64_t k = 0x9e3779b97f4a7c15;
+
+            std::uint64_t h = s.size() * k;
+            std::size_t i = 0;
+            for (; i + 8 <= s.size(); i += 8)
+            {
+                h = (h ^ load_eight_bytes(s.data() + i)) * k;
+            }
+
+            std::uint64_t tail = 0;
+            for (std::size_t j = s.size(); j > i; --j)
+            {
+                tail = (tail << 8) | static_cast<unsigned char>(s[j - 1]);
+            }
+
+            return mix_bits(h ^ tail);
+        }
+
+        // Maps h uniformly onto [0, n) with a multiplication rather than
+        // a division.
+        constexpr std::size_t reduce_hash(std::uint32_t h, std::size_t n)
+        {
+            return static_cast<std::size_t>(
+                (std::uint64_t{ h } * n) >> 32);
+        }
+    }
+
+    // A set of N keywords and their values with a minimal perfect hash:
+    // every keyword hashes to its own slot, so a lookup is two hashes of
+    // the text and a single comparison, whatever N is.
+    //
+    // The hash is built with hash and displace (CHD): keywords are split
+    // into buckets of about two by one hash, and each bucket gets a seed
+    // that sends its keywords to free slots under a second hash. Buckets
+    // are placed largest first, while most slots are still free.
+    template <typename T, std::size_t N>
+    class keyword_table
+    {
+        static_assert(N > 0, "a keyword table needs at least one keyword");
+
+    public:
+        constexpr explicit keyword_table(
+            std::array<keyword_entry<T>, N> const& entries)
+            : keyword_table{ entries, plan(entries),
+                             std::make_index_sequence<N>{} }
+        {
+        }
+
+        // The value of the keyword s, if s is one.
+        constexpr std::optional<T> find(std::string_view s) const
+        {
+            if (s.size() < min_length_ || s.size() > max_length_)
+            {
+                return std::nullopt;
+            }
+
+            auto const& e = entries_[slot(seeds_, detail::keyword_hash(s))];
+            if (e.text != s)
+            {
+                return std::nullopt;
+            }
+
+            return e.value;
+        }
+
+        constexpr parser_info info() const
+        {
+            return { first_, min_length_, max_length_ };
+        }
+
+        // The length of the longest keyword.
+        constexpr std::size_t max_length() const { return max_length_; }
+
+        static constexpr std::size_t size() { return N; }
+
+        constexpr auto begin() const { return entries_.begin(); }
+        constexpr auto end() const { return entries_.end(); }
+
+    private:
+        static constexpr std::size_t bucket_count = (N + 1) / 2;
+
+        using seeds_t = std::array<std::uint32_t, bucket_count>;
+
+        struct layout
+        {
+            // order[i] is the index of the entry in slot i
+            std::array<std::size_t, N> order{};
+            seeds_t seeds{};
+        };
+
+        static constexpr std::size_t slot(seeds_t const& seeds,
+                                          std::uint64_t h)
+        {
+            const auto bucket = detail::reduce_hash(
+                static_cast<std::uint32_t>(h >> 32), bucket_count);
+            return detail::reduce_hash(
+                static_cast<std::uint32_t>(
+                    detail::mix_bits(h ^ seeds[bucket])),
+                N);
+        }
+
+        static constexpr layout plan(
+            std::array<keyword_entry<T>, N> const& entries)
+        {
+            std::array<std::uint64_t, N> hashes{};
+            std::array<std::size_t, bucket_count + 1> starts{};
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                if (entries[i].text.empty())
+                {
+                    throw std::invalid_argument{ "empty keyword" };
+                }
+
+                hashes[i] = detail::keyword_hash(entries[i].text);
+                ++starts[detail::reduce_hash(
+                             static_cast<std::uint32_t>(hashes[i] >> 32),
+                             bucket_count) +
+                         1];
+            }
+
+            // the entries of bucket b are members[starts[b], starts[b + 1])
+            std::size_t largest = 0;
+            for (std::size_t b = 0; b < bucket_count; ++b)
+            {
+                largest = std::max(largest, starts[b + 1]);
+                starts[b + 1] += starts[b];
+            }
+
+            std::array<std::size_t, N> members{};
+            auto fill = starts;
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                const auto b = detail::reduce_hash(
+                    static_cast<std::uint32_t>(hashes[i] >> 32),
+                    bucket_count);
+                members[fill[b]++] = i;
+            }
+
+            layout ret;
+            std::array<bool, N> used{};
+            std::array<std::size_t, N> slots{};
+
+            for (auto size = largest; size > 0; --size)
+            {
+                for (std::size_t b = 0; b < bucket_count; ++b)
+                {
+                    if (starts[b + 1] - starts[b] != size)
+                    {
+                        continue;
+                    }
+
+                    place(entries, hashes, &members[starts[b]], size,
+                          ret.seeds[b], used, slots);
+                    for (std::size_t j = 0; j < size; ++j)
+                    {
+                        used[slots[j]] = true;
+                        ret.order[slots[j]] = members[starts[b] + j];
+                    }
+                }
+            }
+
+            return ret;
+        }
+
+        // Finds the first seed that sends the keywords of a bucket to
+        // distinct free slots, and stores those slots.
+        static constexpr void place(
+            std::array<keyword_entry<T>, N> const& entries,
+            std::array<std::uint64_t, N> const& hashes,
+            const std::size_t* bucket,
+            std::size_t size,
+            std::uint32_t& seed,
+            std::array<bool, N> const& used,
+            std::array<std::size_t, N>& slots)
+        {
+            for (std::size_t j = 0; j < size; ++j)
+            {
+                for (std::size_t k = 0; k < j; ++k)
+                {
+                    if (hashes[bucket[j]] != hashes[bucket[k]])
+                    {
+                        continue;
+                    }
+
+                    if (entries[bucket[j]].text == entries[bucket[k]].text)
+                    {
+                        throw std::invalid_argument{ "duplicate keyword" };
+                    }
+
+                    throw std::invalid_argument{ "keyword hash collision" };
+                }
+            }
+
+            for (std::uint64_t s = 0; s <= 0xffffffff; ++s)
+            {
+                bool fits = true;
+                for (std::size_t j = 0; fits && j < size; ++j)
+                {
+                    slots[j] = detail::reduce_hash(
+                        static_cast<std::uint32_t>(
+                            detail::mix_bits(hashes[bucket[j]] ^ s)),
+                        N);
+                    fits = !used[slots[j]];
+                    for (std::size_t k = 0; fits && k < j; ++k)
+                    {
+                        fits = slots[k] != slots[j];
+                    }
+                }
+
+                if (fits)
+                {
+                    seed = static_cast<std::uint32_t>(s);
+                    return;
+                }
+            }
+
+            throw std::invalid_argument{ "no perfect hash found" };
+        }
+
+        template <std::size_t... I>
+        constexpr keyword_table(std::array<keyword_entry<T>, N> const& entries,
+                                layout const& l,
+                                std::index_sequence<I...>)
+            : entries_{ entries[l.order[I]]... }, seeds_{ l.seeds }
+        {
+            // building a char_class is costly at compile time, so the set
+            // is built once from all of its members
+            std::string firsts;
+            min_length_ = parser_info::unbounded;
+            for (auto const& e : entries)
+            {
+                firsts += e.text.front();
+                min_length_ = std::min(min_length_, e.text.size());
+                max_length_ = std::max(max_length_, e.text.size());
+            }
+
+            first_ = char_class{ firsts };
+        }
+
+        std::array<keyword_entry<T>, N> entries_;
+        seeds_t seeds_;
+        char_class first_;
+        std::size_t min_length_{0};
+        std::size_t max_length_{0};
+    };
+
+    // Builds the keyword table of entries at compile time. A duplicate or
+    // empty keyword is a compile error.
+    //
+    //     static constexpr auto units = ptcore::make_keywords<unit>({
+    //         { "m", unit::metre }, { "s", unit::second }, ... });
+    template <typename T, std::size_t N>
+    consteval keyword_table<T, N> make_keywords(
+        keyword_entry<T> const (&entries)[N])
+    {
+        return keyword_table<T, N>{ std::to_array(entries) };
+    }
+
+    template <typename T, std::size_t N>
+    consteval keyword_table<T, N> make_keywords(
+        std::array<keyword_entry<T>, N> const& entries)
+    {
+        return keyword_table<T, N>{ entries };
+    }
+
+    namespace detail
+    {
+        template <typename T, std::size_t N>
+        struct keyword_parser
+        {
+            constexpr parse_return_t<T> operator()(parse_input_t s) const
+            {
+                return parse_via_cursor(*this, s);
+            }
+
+            constexpr bool parse_into(parse_cursor& c, T& out) const
+            {
+                const auto n = token_length(c.rest());
+                if (const auto v = table->find({ c.pos, n }))
+                {
+                    out = *v;
+                    c.pos += n;
+                    return true;
+                }
+
+                return false;
+            }
+
+            constexpr recognize_return_t recognize(parse_input_t s) const
+            {
+                const auto n = token_length(s);
+                if (table->find(s.substr(0, n)))
+                {
+                    return s.substr(n);
+                }
+
+                return std::nullopt;
+            }
+
+            constexpr parser_info info() const { return table->info(); }
+
+            // The length of the token at the front of s, which is only
+            // scanned far enough to tell that it is too long to be a
+            // keyword.
+            constexpr std::size_t token_length(parse_input_t s) const
+            {
+                return scan_while(token,
+                                  s.substr(0, table->max_length() + 1));
+            }
+
+            keyword_table<T, N> const* table;
+            char_class token;
+        };
+    }
+
+    // Matches the token at the front of the input, the longest run of
+    // members of token, if it is a keyword of table, and gives its value.
+    // The token defaults to char_classes::identifier, so "in" does not
+    // match the start of "int" even where no keyword has a 't'.
+    //
+    // The parser refers to table, which must outlive it.
+    template <typename T, std::size_t N>
+    constexpr auto match_keyword(keyword_table<T, N> const& table)
+    {
+        return detail::keyword_parser<T, N>{ &table,
+                                             char_classes::identifier };
+    }
+
+    template <typename T, std::size_t N>
+    constexpr auto match_keyword(keyword_table<T, N> const& table,
+                                 char_class token)
+    {
+        return detail::keyword_parser<T, N>{ &table, token };
+    }
+}
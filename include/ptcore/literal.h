@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "ptcore/fixed_string.h"
+#include "ptcore/parser.h"
+#include "ptcore/char_class.h"
+#include "ptcore/detail/simd.h"
+#include "ptcore/detail/swar.h"
+
+namespace ptcore
+{
+    namespace detail
+    {
+        template <fixed_string S>
+        struct fixed_literal_parser
+        {
+            static constexpr std::size_t n = S.size();
+
+            constexpr parse_return_t<parse_input_t> operator()(
+                parse_input_t s) const
+            {
+                return parse_via_cursor(*this, s);
+            }
+
+            constexpr bool parse_into(parse_cursor& c,
+                                      parse_input_t& out) const
+            {
+                if (c.size() < n || !matches(c.pos))
+                {
+                    return false;
+                }
+
+                out = { c.pos, n };
+                c.pos += n;
+                return true;
+            }
+
+            constexpr recognize_return_t recognize(parse_input_t s) const
+            {
+                if (s.size() < n || !matches(s.data()))
+                {
+                    return std::nullopt;
+                }
+
+                return s.substr(n);
+            }
+
+            constexpr bool incomplete(parse_input_t s) const
+            {
+                return s.size() < n && S.view().starts_with(s);
+            }
+
+            // A one character literal can take the paths specialized for
+            // match_char.
+            constexpr char literal() const
+            requires(n == 1)
+            {
+                return S[0];
+            }
+
+            constexpr parser_info info() const
+            {
+                return { char_class{ S.view().substr(0, 1) }, n, n };
+            }
+
+            // Whether the n bytes at p are S. Every size gets its own
+            // compare: a few loads of the input, overlapping where n is
+            // not a multiple of the load size, checked against constants.
+            static constexpr bool matches(const char* p)
+            {
+                if consteval
+                {
+                    return parse_input_t{ p, n } == S.view();
+                }
+                else
+                {
+                    if constexpr (n == 0)
+                    {
+                        return true;
+                    }
+                    else if constexpr (n == 1)
+                    {
+                        return *p == S[0];
+                    }
+                    else if constexpr (n < 4)
+                    {
+                        return (diff<std::uint16_t, 0>(p) |
+                                diff<std::uint16_t, n - 2>(p)) == 0;
+                    }
+                    else if constexpr (n < 8)
+                    {
+                        return (diff<std::uint32_t, 0>(p) |
+                                diff<std::uint32_t, n - 4>(p)) == 0;
+                    }
+                    else if constexpr (n <= 16)
+                    {
+                        return (diff<std::uint64_t, 0>(p) |
+                                diff<std::uint64_t, n - 8>(p)) == 0;
+                    }
+                    else
+                    {
+                        return matches_long(p);
+                    }
+                }
+            }
+
+        private:
+            template <typename W, std::size_t Offset>
+            static constexpr W word = load_word<W>(S.chars + Offset);
+
+            // The bits of the W at p + Offset that differ from S.
+            template <typename W, std::size_t Offset>
+            static W diff(const char* p)
+            {
+                return load_word<W>(p + Offset) ^ word<W, Offset>;
+            }
+
+#if PTCORE_SIMD_X86
+            // SSE2 is part of x86-64, so this needs no dispatch.
+            static bool matches_long(const char* p)
+            {
+                const auto block = [p](std::size_t offset)
+                {
+                    return _mm_xor_si128(
+                        _mm_loadu_si128(
+                            reinterpret_cast<const __m128i*>(p + offset)),
+                        _mm_loadu_si128(
+                            reinterpret_cast<const __m128i*>(S.chars +
+                                                             offset)));
+                };
+
+                __m128i acc = block(n - 16);
+                for (std::size_t i = 0; i + 16 < n; i += 16)
+                {
+                    acc = _mm_or_si128(acc, block(i));
+                }
+
+                return _mm_movemask_epi8(
+                           _mm_cmpeq_epi8(acc, _mm_setzero_si128())) ==
+                       0xffff;
+            }
+#else
+            static bool matches_long(const char* p)
+            {
+                std::uint64_t acc = diff<std::uint64_t, n - 8>(p);
+                for (std::size_t i = 0; i + 8 < n; i += 8)
+                {
+                    acc |= load_word<std::uint64_t>(p + i) ^
+                           load_word<std::uint64_t>(S.chars + i);
+                }
+
+                return acc == 0;
+            }
+#endif
+        };
+    }
+
+    // Matches exactly the text S, giving the matched input. The compare is
+    // specialized for S at compile time, so lit<"::="> is two overlapping
+    // 16 bit loads rather than a loop. Usable anywhere a parser is,
+    // including as the separator of match_n, sep_by and match_n_count.
+    template <fixed_string S>
+    inline constexpr detail::fixed_literal_parser<S> lit{};
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <ratio>
+
+#include "ptcore/parser.h"
+#include "ptcore/char_parsers.h"
+#include "ptcore/fixed_string.h"
+#include "ptcore/numeric.h"
+#include "ptcore/rational.h"
+
+namespace ptcore::detail
+{
+    inline constexpr auto ratio_grammar =
+        match_entirety(match_rational<std::intmax_t>());
+
+    inline constexpr auto hms_grammar =
+        match_entirety(match_n<3>(match_integer<int>(), match_char(':')));
+}
+
+// User-defined literals whose text is parsed by ptcore parsers during
+// constant evaluation. The operators are consteval, so a literal costs
+// nothing at run time, and one that does not parse is a compile error
+// naming the expected form.
+namespace ptcore::literals
+{
+    // "3/4"_ratio is a std::ratio<3, 4>, and "6/8"_ratio is the same
+    // type: the terms are reduced before the type is formed. A literal
+    // without a '/' is an integer ratio.
+    template <fixed_string S>
+    consteval auto operator""_ratio()
+    {
+        constexpr auto r = detail::ratio_grammar(S.view());
+        static_assert(r.has_value(),
+                      "malformed _ratio literal: expected n or n/d, with d "
+                      "positive");
+
+        // after a failed parse, a placeholder keeps the static_assert the
+        // only error
+        constexpr auto value = r ? r->value : rational<std::intmax_t>{};
+        return std::ratio<value.num(), value.den()>{};
+    }
+
+    // "12:30:05"_hms is { 12, 30, 5 }.
+    template <fixed_string S>
+    consteval std::array<int, 3> operator""_hms()
+    {
+        constexpr auto r = detail::hms_grammar(S.view());
+        static_assert(r.has_value(),
+                      "malformed _hms literal: expected hh:mm:ss");
+
+        constexpr auto hms = r ? r->value : std::array<int, 3>{};
+        static_assert(hms[0] >= 0 && hms[0] < 24 && hms[1] >= 0 &&
+                          hms[1] < 60 && hms[2] >= 0 && hms[2] < 60,
+                      "_hms literal out of range: expected hours below 24, "
+                      "minutes and seconds below 60");
+
+        return hms;
+    }
+}
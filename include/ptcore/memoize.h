@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ptcore/parser.h"
+
+namespace ptcore
+{
+    namespace detail
+    {
+        template <typename P>
+        class memo_parser;
+    }
+
+    // Owns the memo tables of the memoize parsers created with it. Every
+    // table lives in a single monotonic buffer, so starting a new parse
+    // with reset() releases them all at once.
+    //
+    // An arena and its parsers must only be used by one thread at a time.
+    class memo_arena
+    {
+    public:
+        explicit memo_arena(std::pmr::memory_resource* upstream =
+                                std::pmr::get_default_resource())
+            : resource_{ upstream }
+        {
+        }
+
+        memo_arena(memo_arena const&) = delete;
+        memo_arena& operator=(memo_arena const&) = delete;
+
+        ~memo_arena() { clear(); }
+
+        // Forgets every memoized result and starts a parse of s. Results
+        // are only memoized for suffixes of s.
+        void reset(parse_input_t s)
+        {
+            clear();
+            input_ = s;
+        }
+
+        parse_input_t input() const { return input_; }
+
+    private:
+        template <typename P>
+        friend class detail::memo_parser;
+
+        struct slot
+        {
+            void* table{nullptr};
+            void (*destroy)(void*){nullptr};
+        };
+
+        std::size_t add_slot()
+        {
+            slots_.emplace_back();
+            return slots_.size() - 1;
+        }
+
+        // The table of the slot, created in the buffer on first use after
+        // a reset.
+        template <typename Table>
+        Table& table(std::size_t slot_index)
+        {
+            auto& s = slots_[slot_index];
+            if (s.table == nullptr)
+            {
+                std::pmr::polymorphic_allocator<> alloc{ &resource_ };
+                s.table = alloc.new_object<Table>();
+                s.destroy = [](void* t) { static_cast<Table*>(t)->~Table(); };
+            }
+
+            return *static_cast<Table*>(s.table);
+        }
+
+        void clear()
+        {
+            for (auto& s : slots_)
+            {
+                if (s.table != nullptr)
+                {
+                    s.destroy(s.table);
+                    s.table = nullptr;
+                }
+            }
+
+            resource_.release();
+        }
+
+        std::pmr::monotonic_buffer_resource resource_;
+        std::vector<slot> slots_;
+        parse_input_t input_;
+    };
+
+    namespace detail
+    {
+        // Caches the results of p by offset into the arena's input, so
+        // that a backtracking grammar runs p at most once per position.
+        template <typename P>
+        class memo_parser
+        {
+        public:
+            using result_t = parser_return_type<P const&>;
+
+            memo_parser(P p, memo_arena& arena)
+                : p_{ std::move(p) },
+                  arena_{ &arena },
+                  slot_{ arena.add_slot() }
+            {
+            }
+
+            result_t operator()(parse_input_t s) const
+            {
+                const auto input = arena_->input();
+                if (s.size() > input.size() ||
+                    s.data() + s.size() != input.data() + input.size())
+                {
+                    return p_(s);
+                }
+
+                using table_t =
+                    std::pmr::unordered_map<std::size_t, result_t>;
+                auto& table = arena_->table<table_t>(slot_);
+
+                const std::size_t offset = input.size() - s.size();
+                if (const auto it = table.find(offset); it != table.end())
+                {
+                    return it->second;
+                }
+
+                // p may recursively use this parser, which can rehash the
+                // table, so the result is inserted after it returns
+                auto r = p_(s);
+                table.emplace(offset, r);
+                return r;
+            }
+
+            parser_info info() const { return ptcore::info(p_); }
+
+        private:
+            P p_;
+            memo_arena* arena_;
+            std::size_t slot_;
+        };
+    }
+
+    // Wraps p so its results are memoized in arena between calls to
+    // arena.reset(). Memoized results must be copyable. A left recursive
+    // use of the parser is not detected and does not terminate.
+    template <parser P>
+    requires std::is_copy_constructible_v<parser_parse_type<P>>
+    detail::memo_parser<std::remove_cvref_t<P>> memoize(P&& p,
+                                                        memo_arena& arena)
+    {
+        return { std::forward<P>(p), arena };
+    }
+}
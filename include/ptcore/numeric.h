@@ -0,0 +1,582 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <type_traits>
+
+#include "ptcore/parser.h"
+#include "ptcore/detail/digit_tuple.h"
+#include "ptcore/detail/int128.h"
+#include "ptcore/detail/power_of_five.h"
+#include "ptcore/detail/swar.h"
+
+namespace ptcore
+{
+    namespace detail
+    {
+        template <std::floating_point T>
+        struct binary_format;
+
+        template <>
+        struct binary_format<double>
+        {
+            using bits_type = std::uint64_t;
+
+            static constexpr int mantissa_explicit_bits = 52;
+            static constexpr int minimum_exponent = -1023;
+            static constexpr int infinite_power = 0x7ff;
+            static constexpr int smallest_power_of_ten = -342;
+            static constexpr int largest_power_of_ten = 308;
+            static constexpr int min_exponent_round_to_even = -4;
+            static constexpr int max_exponent_round_to_even = 23;
+            static constexpr int min_exponent_fast_path = -22;
+            static constexpr int max_exponent_fast_path = 22;
+            static constexpr std::uint64_t max_mantissa_fast_path =
+                std::uint64_t{2} << mantissa_explicit_bits;
+        };
+
+        template <>
+        struct binary_format<float>
+        {
+            using bits_type = std::uint32_t;
+
+            static constexpr int mantissa_explicit_bits = 23;
+            static constexpr int minimum_exponent = -127;
+            static constexpr int infinite_power = 0xff;
+            static constexpr int smallest_power_of_ten = -65;
+            static constexpr int largest_power_of_ten = 38;
+            static constexpr int min_exponent_round_to_even = -17;
+            static constexpr int max_exponent_round_to_even = 10;
+            static constexpr int min_exponent_fast_path = -10;
+            static constexpr int max_exponent_fast_path = 10;
+            static constexpr std::uint64_t max_mantissa_fast_path =
+                std::uint64_t{2} << mantissa_explicit_bits;
+        };
+
+        struct adjusted_mantissa
+        {
+            std::uint64_t mantissa{0};
+            int power2{0}; // a negative value indicates an error
+
+            bool operator==(adjusted_mantissa const&) const = default;
+        };
+
+        // floor(log2(10^q)) + 63, valid for q in [-1233, 1233]
+        constexpr int power_of_ten_exponent(int q)
+        {
+            return (((152170 + 65536) * q) >> 16) + 63;
+        }
+
+        // Eisel-Lemire: the correctly rounded binary mantissa and exponent
+        // of w * 10^q, or power2 < 0 when the 128 bit approximation cannot
+        // decide the rounding.
+        template <std::floating_point T>
+        constexpr adjusted_mantissa compute_float(std::int64_t q,
+                                                  std::uint64_t w)
+        {
+            using binary = binary_format<T>;
+
+            adjusted_mantissa answer;
+            if (w == 0 || q < binary::smallest_power_of_ten)
+            {
+                return answer;
+            }
+
+            if (q > binary::largest_power_of_ten)
+            {
+                answer.power2 = binary::infinite_power;
+                return answer;
+            }
+
+            const int lz = std::countl_zero(w);
+            w <<= lz;
+
+            const auto index =
+                2 * static_cast<std::size_t>(q - smallest_power_of_five);
+            constexpr std::uint64_t precision_mask =
+                ~std::uint64_t{0} >> (binary::mantissa_explicit_bits + 3);
+
+            auto product = full_multiplication(w, power_of_five_128[index]);
+            if ((product.high & precision_mask) == precision_mask)
+            {
+                const auto second =
+                    full_multiplication(w, power_of_five_128[index + 1]);
+                product.low += second.high;
+                if (second.high > product.low)
+                {
+                    ++product.high;
+                }
+            }
+
+            if (product.low == ~std::uint64_t{0} && (q < -27 || q > 55))
+            {
+                answer.power2 = -1;
+                return answer;
+            }
+
+            const int upperbit = static_cast<int>(product.high >> 63);
+            const int shift =
+                upperbit + 64 - binary::mantissa_explicit_bits - 3;
+
+            answer.mantissa = product.high >> shift;
+            answer.power2 = power_of_ten_exponent(static_cast<int>(q)) +
+                            upperbit - lz - binary::minimum_exponent;
+
+            if (answer.power2 <= 0)
+            {
+                if (-answer.power2 + 1 >= 64)
+                {
+                    return {};
+                }
+
+                answer.mantissa >>= -answer.power2 + 1;
+                answer.mantissa += (answer.mantissa & 1);
+                answer.mantissa >>= 1;
+                answer.power2 =
+                    answer.mantissa <
+                            (std::uint64_t{1} << binary::mantissa_explicit_bits)
+                        ? 0
+                        : 1;
+                return answer;
+            }
+
+            if (product.low <= 1 &&
+                q >= binary::min_exponent_round_to_even &&
+                q <= binary::max_exponent_round_to_even &&
+                (answer.mantissa & 3) == 1 &&
+                (answer.mantissa << shift) == product.high)
+            {
+                answer.mantissa &= ~std::uint64_t{1};
+            }
+
+            answer.mantissa += (answer.mantissa & 1);
+            answer.mantissa >>= 1;
+            if (answer.mantissa >=
+                (std::uint64_t{2} << binary::mantissa_explicit_bits))
+            {
+                answer.mantissa =
+                    std::uint64_t{1} << binary::mantissa_explicit_bits;
+                ++answer.power2;
+            }
+
+            answer.mantissa &=
+                ~(std::uint64_t{1} << binary::mantissa_explicit_bits);
+            if (answer.power2 >= binary::infinite_power)
+            {
+                answer.power2 = binary::infinite_power;
+                answer.mantissa = 0;
+            }
+
+            return answer;
+        }
+
+        template <std::floating_point T>
+        constexpr T to_float(bool negative, adjusted_mantissa am)
+        {
+            using binary = binary_format<T>;
+            using bits_type = typename binary::bits_type;
+
+            auto bits = static_cast<bits_type>(am.mantissa);
+            bits |= static_cast<bits_type>(am.power2)
+                    << binary::mantissa_explicit_bits;
+            if (negative)
+            {
+                bits |= bits_type{1} << (sizeof(bits_type) * 8 - 1);
+            }
+
+            return std::bit_cast<T>(bits);
+        }
+
+        template <std::floating_point T>
+        constexpr T exact_power_of_ten(int e)
+        {
+            T ret = 1;
+            for (int i = 0; i < e; ++i)
+            {
+                ret *= 10;
+            }
+            return ret;
+        }
+
+        // Reached only in constant evaluation, for inputs that need more
+        // than the 19 significant digits Eisel-Lemire can round from.
+        inline void floating_point_literal_needs_runtime_fallback() {}
+
+        struct decimal_number
+        {
+            std::uint64_t mantissa{0};
+            std::int64_t exponent{0};
+            bool negative{false};
+            bool truncated{false};
+            std::size_t length{0};
+        };
+
+        // [-] digits [. digits] [(e|E) [+|-] digits], with at least one
+        // mantissa digit. Keeps the first 19 significant digits.
+        constexpr std::optional<decimal_number> parse_decimal(parse_input_t s)
+        {
+            constexpr int max_digits = 19;
+
+            decimal_number ret;
+            std::size_t i = 0;
+            int significant = 0;
+            bool any_digit = false;
+
+            if (i < s.size() && s[i] == '-')
+            {
+                ret.negative = true;
+                ++i;
+            }
+
+            const auto add_digit = [&](int d, bool fraction)
+            {
+                any_digit = true;
+                if (ret.mantissa == 0 && d == 0)
+                {
+                    ret.exponent -= fraction ? 1 : 0;
+                }
+                else if (significant < max_digits)
+                {
+                    ret.mantissa = ret.mantissa * 10 +
+                                   static_cast<std::uint64_t>(d);
+                    ++significant;
+                    ret.exponent -= fraction ? 1 : 0;
+                }
+                else
+                {
+                    ret.exponent += fraction ? 0 : 1;
+                    ret.truncated = ret.truncated || d != 0;
+                }
+            };
+
+            const auto add_digits = [&](bool fraction)
+            {
+                for (;;)
+                {
+                    if (ret.mantissa != 0 && significant + 8 <= max_digits &&
+                        i + 8 <= s.size())
+                    {
+                        const auto chunk = load_eight_bytes(s.data() + i);
+                        if (is_eight_digits(chunk))
+                        {
+                            ret.mantissa = ret.mantissa * 100000000 +
+                                           parse_eight_digits(chunk);
+                            significant += 8;
+                            ret.exponent -= fraction ? 8 : 0;
+                            i += 8;
+                            continue;
+                        }
+                    }
+
+                    if (i < s.size() && is_digit(s[i]))
+                    {
+                        add_digit(s[i] - '0', fraction);
+                        ++i;
+                        continue;
+                    }
+
+                    break;
+                }
+            };
+
+            add_digits(false);
+            if (i < s.size() && s[i] == '.')
+            {
+                ++i;
+                add_digits(true);
+            }
+
+            if (!any_digit)
+            {
+                return std::nullopt;
+            }
+
+            if (i < s.size() && (s[i] == 'e' || s[i] == 'E'))
+            {
+                std::size_t j = i + 1;
+                bool negative_exponent = false;
+                if (j < s.size() && (s[j] == '+' || s[j] == '-'))
+                {
+                    negative_exponent = s[j] == '-';
+                    ++j;
+                }
+
+                if (j < s.size() && is_digit(s[j]))
+                {
+                    std::int64_t e = 0;
+                    for (; j < s.size() && is_digit(s[j]); ++j)
+                    {
+                        if (e < 0x10000000)
+                        {
+                            e = e * 10 + (s[j] - '0');
+                        }
+                    }
+
+                    ret.exponent += negative_exponent ? -e : e;
+                    i = j;
+                }
+            }
+
+            ret.length = i;
+            return ret;
+        }
+
+        template <std::floating_point T>
+        constexpr T decimal_to_float(decimal_number const& d,
+                                     parse_input_t text)
+        {
+            using binary = binary_format<T>;
+
+            if (d.mantissa == 0)
+            {
+                return d.negative ? -T{0} : T{0};
+            }
+
+            // Clinger's fast path: both operands are exact
+            if (!d.truncated && d.mantissa <= binary::max_mantissa_fast_path &&
+                d.exponent >= binary::min_exponent_fast_path &&
+                d.exponent <= binary::max_exponent_fast_path)
+            {
+                auto ret = static_cast<T>(d.mantissa);
+                if (d.exponent < 0)
+                {
+                    ret /= exact_power_of_ten<T>(static_cast<int>(-d.exponent));
+                }
+                else
+                {
+                    ret *= exact_power_of_ten<T>(static_cast<int>(d.exponent));
+                }
+                return d.negative ? -ret : ret;
+            }
+
+            auto am = compute_float<T>(d.exponent, d.mantissa);
+            if (d.truncated && am.power2 >= 0 &&
+                am != compute_float<T>(d.exponent, d.mantissa + 1))
+            {
+                am.power2 = -1;
+            }
+
+            if (am.power2 >= 0)
+            {
+                return to_float<T>(d.negative, am);
+            }
+
+            if consteval
+            {
+                floating_point_literal_needs_runtime_fallback();
+                return T{};
+            }
+            else
+            {
+                T ret{};
+                std::from_chars(text.data(), text.data() + text.size(), ret);
+                return ret;
+            }
+        }
+    }
+
+    namespace detail
+    {
+        template <std::integral T>
+        struct integer_parser
+        {
+            // Unsigned integers accept exactly a run of digits, which lets
+            // parse_batch convert them with SIMD.
+            static constexpr bool digits_only = std::is_unsigned_v<T>;
+
+            constexpr parse_return_t<T> operator()(parse_input_t s) const
+            {
+                return parse_via_cursor(*this, s);
+            }
+
+            constexpr bool parse_into(parse_cursor& c, T& out) const
+            {
+                auto s = c.rest();
+
+                bool negative = false;
+                if constexpr (std::is_signed_v<T>)
+                {
+                    if (!s.empty() && s.front() == '-')
+                    {
+                        negative = true;
+                        s.remove_prefix(1);
+                    }
+                }
+
+                using U = std::make_unsigned_t<T>;
+                const std::uint64_t max =
+                    static_cast<U>(std::numeric_limits<T>::max()) +
+                    (negative ? 1u : 0u);
+
+                const auto r = parse_digits(s, max);
+                if (r.length == 0 || r.overflow)
+                {
+                    return false;
+                }
+
+                auto value = static_cast<U>(r.value);
+                if (negative)
+                {
+                    value = static_cast<U>(U{0} - value);
+                }
+
+                out = static_cast<T>(value);
+                c.pos = s.data() + r.length;
+                return true;
+            }
+
+#if PTCORE_SIMD_X86
+            // match_n of unsigned integers separated by one character: a
+            // tuple that fits in 16 bytes is parsed in one SIMD pass.
+            template <std::size_t N>
+            requires std::is_unsigned_v<T>
+            std::optional<bool> parse_tuple(parse_cursor& c,
+                                            char sep,
+                                            std::array<T, N>& out) const
+            {
+                const auto r = match_digit_tuple(c.rest(), sep, out);
+                if (r.status == kernel_status::matched)
+                {
+                    c.pos += r.length;
+                    return true;
+                }
+
+                if (r.status == kernel_status::failed)
+                {
+                    return false;
+                }
+
+                return std::nullopt;
+            }
+#endif
+
+            // Runs of up to digits10 digits always fit, so only longer ones
+            // need converting to check for overflow.
+            constexpr recognize_return_t recognize(parse_input_t s) const
+            {
+                std::size_t sign = 0;
+                if constexpr (std::is_signed_v<T>)
+                {
+                    sign = !s.empty() && s.front() == '-' ? 1 : 0;
+                }
+
+                const auto length = count_digits(s.substr(sign));
+                if (length == 0)
+                {
+                    return std::nullopt;
+                }
+
+                if (length <= std::numeric_limits<T>::digits10)
+                {
+                    return s.substr(sign + length);
+                }
+
+                if (const auto r = (*this)(s))
+                {
+                    return r->remaining_input;
+                }
+
+                return std::nullopt;
+            }
+
+            // Without digits, only a lone sign can still become a match;
+            // digits that overflow only overflow further.
+            constexpr bool incomplete(parse_input_t s) const
+            {
+                if constexpr (std::is_signed_v<T>)
+                {
+                    return s.empty() || s == "-";
+                }
+                else
+                {
+                    return s.empty();
+                }
+            }
+
+            constexpr parser_info info() const
+            {
+                if constexpr (std::is_signed_v<T>)
+                {
+                    return { char_classes::digit | char_class{ "-" }, 1,
+                             parser_info::unbounded };
+                }
+                else
+                {
+                    return { char_classes::digit, 1, parser_info::unbounded };
+                }
+            }
+        };
+    }
+
+    // Matches an optional '-' (signed types only) followed by decimal
+    // digits. Fails if the value does not fit in T.
+    template <std::integral T>
+    requires(!std::same_as<T, bool> && sizeof(T) <= sizeof(std::uint64_t))
+    constexpr auto match_integer()
+    {
+        return detail::integer_parser<T>{};
+    }
+
+    namespace detail
+    {
+        template <std::floating_point T>
+        struct floating_point_parser
+        {
+            constexpr parse_return_t<T> operator()(parse_input_t s) const
+            {
+                if (const auto d = parse_decimal(s))
+                {
+                    return parse_results{
+                        decimal_to_float<T>(*d, s.substr(0, d->length)),
+                        s.substr(d->length) };
+                }
+
+                return std::nullopt;
+            }
+
+            // The syntax alone decides success; the binary conversion is
+            // skipped.
+            constexpr recognize_return_t recognize(parse_input_t s) const
+            {
+                if (const auto d = parse_decimal(s))
+                {
+                    return s.substr(d->length);
+                }
+
+                return std::nullopt;
+            }
+
+            // Only input without a digit fails: an empty one or a prefix
+            // of "-.".
+            constexpr bool incomplete(parse_input_t s) const
+            {
+                return s.empty() || s == "-" || s == "." || s == "-.";
+            }
+
+            constexpr parser_info info() const
+            {
+                return { char_classes::digit | char_class{ "-." }, 1,
+                         parser_info::unbounded };
+            }
+        };
+    }
+
+    // Matches a decimal floating point number, independent of the current
+    // locale: an optional '-', digits with an optional '.', at least one
+    // digit in all, and an optional exponent of 'e' or 'E', an optional
+    // sign and digits, e.g. "-1.5e-3" or ".5". "inf", "infinity" and "nan"
+    // are not accepted. Values outside the range of T become zero or
+    // infinity.
+    template <std::floating_point T>
+    requires(std::same_as<T, float> || std::same_as<T, double>)
+    constexpr auto match_floating_point()
+    {
+        return detail::floating_point_parser<T>{};
+    }
+}
@@ -0,0 +1,272 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "ptcore/parser.h"
+#include "ptcore/char_parsers.h"
+
+// The parallel_ functions run on std::thread, so a program that calls them
+// must link a thread library, e.g. with CMake:
+//
+//     find_package(Threads REQUIRED)
+//     target_link_libraries(app PRIVATE ptcore::ptcore Threads::Threads)
+//
+// ptcore::ptcore does not link one itself, as most of the library needs
+// none.
+namespace ptcore
+{
+    template <typename T>
+    struct separated_list
+    {
+        std::vector<T> values;
+        bool full_match{false};
+    };
+
+    // Like match_n_count, but keeps the parsed values.
+    template <parser P, parser Separator>
+    separated_list<parser_parse_type<P>> collect_separated(P&& p,
+                                                           Separator&& sep,
+                                                           parse_input_t s)
+    {
+        separated_list<parser_parse_type<P>> ret;
+
+        auto r = p(s);
+        while (r)
+        {
+            ret.values.push_back(std::move(r->value));
+            if (r->input_done())
+            {
+                ret.full_match = true;
+                break;
+            }
+
+            const auto r2 = sep(r->remaining_input);
+            if (!r2)
+            {
+                break;
+            }
+
+            r = p(r2->remaining_input);
+        }
+
+        return ret;
+    }
+
+    struct parallel_options
+    {
+        // 0 uses std::thread::hardware_concurrency()
+        std::size_t threads{0};
+
+        // inputs are not split into chunks smaller than this
+        std::size_t min_chunk_size{std::size_t{1} << 20};
+    };
+
+    namespace detail
+    {
+        // Splits s into chunks of about chunk_size bytes, each ending just
+        // before a separator byte. The separators themselves belong to no
+        // chunk, so chunk i + 1 starts where the sequential parse of the
+        // whole input would be after matching that separator.
+        inline std::vector<parse_input_t> split_at_separators(
+            parse_input_t s, char separator, std::size_t chunk_size)
+        {
+            std::vector<parse_input_t> ret;
+
+            while (s.size() > chunk_size)
+            {
+                const auto pos = s.find(separator, chunk_size);
+                if (pos == parse_input_t::npos)
+                {
+                    break;
+                }
+
+                ret.push_back(s.substr(0, pos));
+                s.remove_prefix(pos + 1);
+            }
+
+            ret.push_back(s);
+            return ret;
+        }
+
+        // Runs f(i) for every chunk index on a pool of threads that take
+        // the next unclaimed chunk as they finish their previous one, so
+        // slow chunks do not hold up the others. Chunks after the first one
+        // for which f returns false are skipped, since the merge stops
+        // there anyway.
+        template <typename F>
+        void run_chunks(std::size_t count, std::size_t threads, F&& f)
+        {
+            std::atomic<std::size_t> next{0};
+            std::atomic<std::size_t> first_failed{count};
+            std::exception_ptr error;
+            std::mutex error_mutex;
+
+            const auto work = [&]
+            {
+                for (;;)
+                {
+                    const auto i = next.fetch_add(1, std::memory_order_relaxed);
+                    if (i >= count ||
+                        i > first_failed.load(std::memory_order_relaxed))
+                    {
+                        return;
+                    }
+
+                    try
+                    {
+                        if (!f(i))
+                        {
+                            auto failed =
+                                first_failed.load(std::memory_order_relaxed);
+                            while (i < failed &&
+                                   !first_failed.compare_exchange_weak(
+                                       failed, i, std::memory_order_relaxed))
+                            {
+                            }
+                        }
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard lock{ error_mutex };
+                        if (!error)
+                        {
+                            error = std::current_exception();
+                        }
+                        next.store(count, std::memory_order_relaxed);
+                    }
+                }
+            };
+
+            {
+                std::vector<std::jthread> pool;
+                const auto helpers = std::min(threads, count) - 1;
+                pool.reserve(helpers);
+                for (std::size_t i = 0; i < helpers; ++i)
+                {
+                    pool.emplace_back(work);
+                }
+
+                work();
+            }
+
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+
+        inline std::size_t thread_count(parallel_options const& opts)
+        {
+            if (opts.threads != 0)
+            {
+                return opts.threads;
+            }
+
+            return std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        inline std::size_t chunk_size(parse_input_t s,
+                                      std::size_t threads,
+                                      parallel_options const& opts)
+        {
+            // a few chunks per thread keeps the threads busy when chunks
+            // parse at different speeds
+            return std::max(opts.min_chunk_size, s.size() / (threads * 4) + 1);
+        }
+    }
+
+    // The result of match_n_count(p, match_char(separator), s), computed by
+    // parsing chunks of s on several threads. p must not consume a
+    // separator byte.
+    template <parser P>
+    match_n_count_result parallel_match_n_count(P const& p,
+                                                char separator,
+                                                parse_input_t s,
+                                                parallel_options opts = {})
+    {
+        const auto threads = detail::thread_count(opts);
+        const auto chunks = detail::split_at_separators(
+            s, separator, detail::chunk_size(s, threads, opts));
+
+        std::vector<match_n_count_result> results(chunks.size());
+        detail::run_chunks(chunks.size(), threads,
+                           [&](std::size_t i)
+                           {
+                               results[i] = match_n_count(
+                                   p, match_char(separator), chunks[i]);
+                               return results[i].full_match;
+                           });
+
+        match_n_count_result ret;
+        for (auto const& r : results)
+        {
+            ret.count += r.count;
+            if (!r.full_match)
+            {
+                return ret;
+            }
+        }
+
+        ret.full_match = true;
+        return ret;
+    }
+
+    // The result of collect_separated(p, match_char(separator), s),
+    // computed by parsing chunks of s on several threads and joining the
+    // values in input order. p must not consume a separator byte.
+    template <parser P>
+    separated_list<parser_parse_type<P>> parallel_collect_separated(
+        P const& p,
+        char separator,
+        parse_input_t s,
+        parallel_options opts = {})
+    {
+        using list_t = separated_list<parser_parse_type<P>>;
+
+        const auto threads = detail::thread_count(opts);
+        const auto chunks = detail::split_at_separators(
+            s, separator, detail::chunk_size(s, threads, opts));
+
+        std::vector<list_t> results(chunks.size());
+        detail::run_chunks(chunks.size(), threads,
+                           [&](std::size_t i)
+                           {
+                               results[i] = collect_separated(
+                                   p, match_char(separator), chunks[i]);
+                               return results[i].full_match;
+                           });
+
+        std::size_t total = 0;
+        for (auto const& r : results)
+        {
+            total += r.values.size();
+            if (!r.full_match)
+            {
+                break;
+            }
+        }
+
+        list_t ret;
+        ret.values.reserve(total);
+        for (auto& r : results)
+        {
+            std::move(r.values.begin(), r.values.end(),
+                      std::back_inserter(ret.values));
+            if (!r.full_match)
+            {
+                return ret;
+            }
+        }
+
+        ret.full_match = true;
+        return ret;
+    }
+}
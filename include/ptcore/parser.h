@@ -4,12 +4,22 @@
 #include <optional>
 #include <concepts>
 #include <array>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
 #include <type_traits>
+#include <utility>
+
+#include "ptcore/char_class.h"
 
 namespace ptcore
 {
     using parse_input_t = std::string_view;
 
+    // The result of a successful parse. remaining_input is the input that
+    // follows the match, a suffix of the input the parser was given, which
+    // is what lets callers tell where a match ends by its size alone; an
+    // empty remaining_input may also be a default constructed view.
     template <typename T>
     struct parse_results
     {
@@ -47,6 +57,8 @@ namespace ptcore
             is_parse_return_type<T>::value;
     }
 
+    // A parser returns parse_results on a match, with the remaining input
+    // a suffix of its input, and nullopt otherwise.
     template <typename P>
     concept parser = requires(P p, parse_input_t i)
     {
@@ -64,39 +76,368 @@ namespace ptcore
     template <parser P>
     using parser_parse_type = typename parser_results_type<P>::parse_type;
 
+    namespace detail
+    {
+        // Parsers that match exactly a run of decimal digits into an
+        // unsigned integer, e.g. match_integer<unsigned>()
+        template <typename P>
+        concept digits_only_parser =
+            std::unsigned_integral<parser_parse_type<P>> &&
+            requires { requires std::remove_cvref_t<P>::digits_only; };
+
+        // Parsers that match exactly one known character, e.g.
+        // match_char(':')
+        template <typename P>
+        concept char_literal_parser = requires(std::remove_cvref_t<P> const& p)
+        {
+            { p.literal() } -> std::same_as<char>;
+        };
+    }
+
+    using recognize_return_t = std::optional<parse_input_t>;
+
+    // A parser that can also check its input without building a value:
+    // recognize(s) returns the remaining input exactly when p(s) succeeds.
+    template <typename P>
+    concept recognizer = parser<P> && requires(P const& p, parse_input_t i)
+    {
+        { p.recognize(i) } -> std::same_as<recognize_return_t>;
+    };
+
+    // Runs p in validate-only mode, using its recognize path if it has one.
     template <parser P>
-    constexpr auto match_entirety(P&& p)
+    constexpr recognize_return_t recognize(P const& p, parse_input_t s)
     {
-        return [=](parse_input_t s) -> parser_return_type<P>
+        if constexpr (recognizer<P>)
+        {
+            return p.recognize(s);
+        }
+        else
         {
-            if (const auto r = p(s); r && r->input_done())
+            if (const auto r = p(s))
             {
-                return r;
+                return r->remaining_input;
             }
 
             return std::nullopt;
+        }
+    }
+
+    // The unparsed part of the input as a pair of pointers, which fits in
+    // two registers and advances without building a new string_view.
+    struct parse_cursor
+    {
+        constexpr parse_cursor() = default;
+
+        constexpr explicit parse_cursor(parse_input_t s)
+            : pos{ s.data() }, end{ s.data() + s.size() }
+        {
+        }
+
+        constexpr std::size_t size() const
+        {
+            return static_cast<std::size_t>(end - pos);
+        }
+
+        constexpr bool empty() const { return pos == end; }
+
+        constexpr parse_input_t rest() const { return { pos, size() }; }
+
+        const char* pos{nullptr};
+        const char* end{nullptr};
+    };
+
+    // A parser that can also write its value into storage owned by the
+    // caller: parse_into(c, out) returns true and advances c exactly when
+    // p(c.rest()) succeeds, and leaves c unchanged otherwise. out is
+    // unspecified after a failure.
+    template <typename P>
+    concept cursor_parser = parser<P> &&
+        requires(P const& p, parse_cursor& c, parser_parse_type<P const&>& out)
+    {
+        { p.parse_into(c, out) } -> std::same_as<bool>;
+    };
+
+    // Runs p over the cursor, writing its value directly into out if p
+    // supports it and moving it there otherwise. Throws std::logic_error if
+    // p gives a remaining input that is not a suffix of c.rest().
+    template <parser P>
+    constexpr bool parse_into(P const& p,
+                              parse_cursor& c,
+                              parser_parse_type<P const&>& out)
+    {
+        if constexpr (cursor_parser<P>)
+        {
+            return p.parse_into(c, out);
+        }
+        else
+        {
+            auto r = p(c.rest());
+            if (!r)
+            {
+                return false;
+            }
+
+            const auto rest = r->remaining_input;
+            if (!rest.empty() &&
+                (rest.size() > c.size() || rest.data() + rest.size() != c.end))
+            {
+                throw std::logic_error{ "parse_into: remaining_input is not "
+                                        "a suffix of the input" };
+            }
+
+            out = std::move(r->value);
+            c.pos = c.end - rest.size();
+            return true;
+        }
+    }
+
+    namespace detail
+    {
+        // The parser protocol in terms of parse_into, for parsers that
+        // implement the cursor one.
+        template <typename P>
+        constexpr parse_return_t<parser_parse_type<P const&>> parse_via_cursor(
+            P const& p, parse_input_t s)
+        {
+            parse_results<parser_parse_type<P const&>> ret;
+            parse_cursor c{ s };
+            if (!p.parse_into(c, ret.value))
+            {
+                return std::nullopt;
+            }
+
+            ret.remaining_input = c.rest();
+            return ret;
+        }
+    }
+
+    // What a parser can tell about its matches before running: the bytes a
+    // non-empty match can start with, and bounds on the number of bytes a
+    // match consumes. The defaults describe a parser that could do anything.
+    struct parser_info
+    {
+        static constexpr std::size_t unbounded =
+            std::numeric_limits<std::size_t>::max();
+
+        char_class first{ ~char_class{} };
+        std::size_t min_length{0};
+        std::size_t max_length{unbounded};
+
+        constexpr bool nullable() const { return min_length == 0; }
+
+        // Whether a match can possibly start at the front of s.
+        constexpr bool viable(parse_input_t s) const
+        {
+            return s.size() >= min_length &&
+                   (nullable() || first.contains(s.front()));
+        }
+    };
+
+    template <typename P>
+    concept described_parser = parser<P> && requires(P const& p)
+    {
+        { p.info() } -> std::same_as<parser_info>;
+    };
+
+    template <parser P>
+    constexpr parser_info info(P const& p)
+    {
+        if constexpr (described_parser<P>)
+        {
+            return p.info();
+        }
+        else
+        {
+            return {};
+        }
+    }
+
+    // A parser that can tell input that does not match from input that
+    // ends too soon: for an s that p does not match, p.incomplete(s) is
+    // true exactly when some longer input starting with s could match,
+    // that is, when the failure reached the end of s.
+    template <typename P>
+    concept incremental_parser = parser<P> &&
+        requires(P const& p, parse_input_t i)
+    {
+        { p.incomplete(i) } -> std::same_as<bool>;
+    };
+
+    // Whether p fails on s only for want of input. Parsers that cannot
+    // tell are judged by their info alone, which takes any failure on a
+    // possible start of a match, shorter than the longest match, to be
+    // incomplete.
+    template <parser P>
+    constexpr bool incomplete(P const& p, parse_input_t s)
+    {
+        if constexpr (incremental_parser<P>)
+        {
+            return p.incomplete(s);
+        }
+        else
+        {
+            const auto i = ptcore::info(p);
+            return s.size() < i.max_length &&
+                   (s.empty() || i.nullable() || i.first.contains(s.front()));
+        }
+    }
+
+    namespace detail
+    {
+        // Walks the parts of a sequence over s, one step(q) per part, to
+        // tell whether the sequence is incomplete on s: it is if a part
+        // fails incompletely, or if a part that matched reached the end of
+        // s, as the part might have matched more of longer input.
+        struct sequence_walk
+        {
+            // Matches q at the front of rest, and returns whether the walk
+            // goes on.
+            template <typename Q>
+            constexpr bool step(Q const& q)
+            {
+                const auto r = ptcore::recognize(q, rest);
+                if (!r)
+                {
+                    result = ptcore::incomplete(q, rest);
+                    return false;
+                }
+
+                if (r->empty())
+                {
+                    result = true;
+                    return false;
+                }
+
+                rest = *r;
+                return true;
+            }
+
+            parse_input_t rest;
+            bool result{false};
         };
     }
 
+    namespace detail
+    {
+        constexpr std::size_t add_lengths(std::size_t a, std::size_t b)
+        {
+            return a > parser_info::unbounded - b ? parser_info::unbounded
+                                                  : a + b;
+        }
+
+        // The info of a followed by b.
+        constexpr parser_info sequence_info(parser_info const& a,
+                                            parser_info const& b)
+        {
+            return { a.nullable() ? a.first | b.first : a.first,
+                     add_lengths(a.min_length, b.min_length),
+                     add_lengths(a.max_length, b.max_length) };
+        }
+
+        constexpr std::size_t multiply_length(std::size_t length,
+                                              std::size_t n)
+        {
+            return n != 0 && length > parser_info::unbounded / n
+                       ? parser_info::unbounded
+                       : length * n;
+        }
+
+        // The info of n matches of p, separated by sep.
+        constexpr parser_info repeat_info(parser_info const& p,
+                                          parser_info const& sep,
+                                          std::size_t n)
+        {
+            if (n == 0)
+            {
+                return { char_class{}, 0, 0 };
+            }
+
+            return { p.nullable() && n > 1 ? p.first | sep.first : p.first,
+                     add_lengths(multiply_length(p.min_length, n),
+                                 multiply_length(sep.min_length, n - 1)),
+                     add_lengths(multiply_length(p.max_length, n),
+                                 multiply_length(sep.max_length, n - 1)) };
+        }
+    }
+
+    namespace detail
+    {
+        template <typename P>
+        struct entirety_parser
+        {
+            constexpr parser_return_type<P const&> operator()(
+                parse_input_t s) const
+            {
+                if (const auto r = p(s); r && r->input_done())
+                {
+                    return r;
+                }
+
+                return std::nullopt;
+            }
+
+            constexpr recognize_return_t recognize(parse_input_t s) const
+            {
+                if (const auto r = ptcore::recognize(p, s); r && r->empty())
+                {
+                    return r;
+                }
+
+                return std::nullopt;
+            }
+
+            constexpr bool parse_into(parse_cursor& c,
+                                      parser_parse_type<P const&>& out) const
+            {
+                auto next = c;
+                if (ptcore::parse_into(p, next, out) && next.empty())
+                {
+                    c = next;
+                    return true;
+                }
+
+                return false;
+            }
+
+            constexpr bool incomplete(parse_input_t s) const
+            {
+                return !ptcore::recognize(p, s) && ptcore::incomplete(p, s);
+            }
+
+            constexpr parser_info info() const { return ptcore::info(p); }
+
+            P p;
+        };
+    }
+
+    template <parser P>
+    constexpr auto match_entirety(P&& p)
+    {
+        return detail::entirety_parser<std::remove_cvref_t<P>>{
+            std::forward<P>(p) };
+    }
+
     struct match_n_count_result
     {
         std::size_t count{0};
         bool full_match{false};
     };
 
+    // Only the count is returned, so p and sep run in recognize mode.
     template <parser P, parser Separator>
     constexpr match_n_count_result match_n_count(P&& p,
                                                Separator&& sep,
                                                parse_input_t s)
     {
-        if (const auto r = p(s))
+        if (const auto r = recognize(p, s))
         {
-            if (r->input_done())
+            if (r->empty())
             {
                 return { 1, true };
             }
 
-            s = r->remaining_input;
+            s = *r;
         }
         else
         {
@@ -107,22 +448,22 @@ namespace ptcore
 
         for (;;)
         {
-            const auto r = sep(s);
+            const auto r = recognize(sep, s);
             if (!r)
             {
                 break;
             }
 
-            if (const auto r2 = p(r->remaining_input))
+            if (const auto r2 = recognize(p, *r))
             {
                 ++ret.count;
-                if (r2->input_done())
+                if (r2->empty())
                 {
                     ret.full_match = true;
                     break;
                 }
 
-                s = r2->remaining_input;
+                s = *r2;
             }
             else
             {
@@ -133,46 +474,137 @@ namespace ptcore
         return ret;
     }
 
-    template <std::size_t N, parser P, parser Separator>
-    requires(N > 0)
-    constexpr auto match_n(P&& p, Separator&& sep)
+    namespace detail
     {
-        using array_t = std::array<parser_parse_type<P>, N>;
+        // Parsers with a faster way to match a fixed tuple of their values
+        // separated by one known character than one value at a time, e.g.
+        // match_integer<unsigned>(). p.parse_tuple(c, sep, out) returns
+        // what parse_into would for the whole tuple, advancing c only on
+        // true, or nullopt to leave c to the generic path. It is not
+        // constexpr.
+        template <typename P, typename Array>
+        concept tuple_parser = requires(P const& p,
+                                        parse_cursor& c,
+                                        Array& out)
+        {
+            { p.parse_tuple(c, ':', out) } -> std::same_as<std::optional<bool>>;
+        };
 
-        return [=](parse_input_t s) -> parse_return_t<array_t>
+        template <std::size_t N, typename P, typename Separator>
+        struct n_parser
         {
-            array_t ret;
+            using array_t = std::array<parser_parse_type<P const&>, N>;
 
-            if (const auto r = p(s))
+            constexpr n_parser(P p, Separator sep)
+                : p{ std::move(p) },
+                  sep{ std::move(sep) },
+                  min_length{ info().min_length }
             {
-                ret[0] = r->value;
-                s = r->remaining_input;
             }
-            else
+
+            constexpr parse_return_t<array_t> operator()(parse_input_t s) const
             {
-                return std::nullopt;
+                return parse_via_cursor(*this, s);
             }
 
-            for (std::size_t i = 1; i < N; ++i)
+            // Each element is parsed straight into its slot of out.
+            constexpr bool parse_into(parse_cursor& c, array_t& out) const
             {
-                const auto r = sep(s);
-                if (!r)
+                if (c.size() < min_length)
                 {
-                    return std::nullopt;
+                    return false;
                 }
 
-                if (const auto r2 = p(r->remaining_input))
+                if constexpr (tuple_parser<P, array_t> &&
+                              char_literal_parser<Separator>)
                 {
-                    ret[i] = r2->value;
-                    s = r2->remaining_input;
+                    if !consteval
+                    {
+                        if (const auto r = p.parse_tuple(c, sep.literal(), out))
+                        {
+                            return *r;
+                        }
+                    }
                 }
-                else
+
+                auto next = c;
+                for (std::size_t i = 0; i < N; ++i)
+                {
+                    if (i > 0)
+                    {
+                        const auto r = ptcore::recognize(sep, next.rest());
+                        if (!r)
+                        {
+                            return false;
+                        }
+
+                        next.pos = next.end - r->size();
+                    }
+
+                    if (!ptcore::parse_into(p, next, out[i]))
+                    {
+                        return false;
+                    }
+                }
+
+                c = next;
+                return true;
+            }
+
+            constexpr recognize_return_t recognize(parse_input_t s) const
+            {
+                if (s.size() < min_length)
                 {
                     return std::nullopt;
                 }
+
+                auto r = ptcore::recognize(p, s);
+                for (std::size_t i = 1; r && i < N; ++i)
+                {
+                    r = ptcore::recognize(sep, *r);
+                    if (r)
+                    {
+                        r = ptcore::recognize(p, *r);
+                    }
+                }
+
+                return r;
             }
 
-            return parse_results{std::move(ret), s};
+            constexpr bool incomplete(parse_input_t s) const
+            {
+                sequence_walk w{ s };
+                for (std::size_t i = 0; i < N; ++i)
+                {
+                    if ((i > 0 && !w.step(sep)) || !w.step(p))
+                    {
+                        break;
+                    }
+                }
+
+                return w.result;
+            }
+
+            constexpr parser_info info() const
+            {
+                return repeat_info(ptcore::info(p), ptcore::info(sep), N);
+            }
+
+            P p;
+            Separator sep;
+
+            // input shorter than this cannot match, so it is rejected
+            // before running p
+            std::size_t min_length;
         };
     }
+
+    template <std::size_t N, parser P, parser Separator>
+    requires(N > 0)
+    constexpr auto match_n(P&& p, Separator&& sep)
+    {
+        return detail::n_parser<N, std::remove_cvref_t<P>,
+                                std::remove_cvref_t<Separator>>{
+            std::forward<P>(p), std::forward<Separator>(sep) };
+    }
 }
@@ -0,0 +1,544 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ptcore/parser.h"
+#include "ptcore/char_parsers.h"
+#include "ptcore/detail/simd.h"
+
+namespace ptcore
+{
+    // The first occurrence of a pattern_set pattern in the input.
+    struct pattern_match
+    {
+        bool operator==(pattern_match const&) const = default;
+
+        // the index of the pattern in the set
+        std::size_t id{0};
+
+        // the input before the match
+        parse_input_t skipped;
+
+        // the matched text
+        parse_input_t text;
+    };
+
+    namespace detail
+    {
+        struct pattern_hit
+        {
+            std::size_t start;
+            std::size_t length;
+            std::size_t id;
+
+            // The match that starts first wins; of those that start at
+            // the same place, the one with the lowest id.
+            constexpr bool better_than(pattern_hit const& other) const
+            {
+                return start != other.start ? start < other.start
+                                            : id < other.id;
+            }
+        };
+
+        // An Aho-Corasick automaton compiled to a DFA, so each input byte
+        // is one table lookup. Bytes are first mapped to classes, with all
+        // the bytes that occur in no pattern sharing one, and the
+        // transitions of a state are a row of the flat table.
+        class pattern_automaton
+        {
+        public:
+            explicit pattern_automaton(
+                std::vector<std::string> const& patterns)
+            {
+                std::array<bool, 256> used{};
+                for (auto const& p : patterns)
+                {
+                    for (const auto ch : p)
+                    {
+                        used[static_cast<unsigned char>(ch)] = true;
+                    }
+                }
+
+                classes_ = 1;
+                for (std::size_t b = 0; b < 256; ++b)
+                {
+                    if (used[b])
+                    {
+                        class_of_[b] = static_cast<std::uint16_t>(classes_++);
+                    }
+                }
+
+                // the trie, with 0 for a missing child, as the root is
+                // nobody's child
+                std::vector<std::uint32_t> next(classes_, 0);
+                depth_.push_back(0);
+                outputs_.push_back({});
+
+                std::string firsts;
+                for (std::size_t id = 0; id < patterns.size(); ++id)
+                {
+                    auto const& p = patterns[id];
+                    firsts += p.front();
+
+                    std::uint32_t state = 0;
+                    for (const auto ch : p)
+                    {
+                        const auto i = state * classes_ + class_of(ch);
+                        if (next[i] == 0)
+                        {
+                            next[i] =
+                                static_cast<std::uint32_t>(depth_.size());
+                            next.resize(next.size() + classes_, 0);
+                            depth_.push_back(depth_[state] + 1);
+                            outputs_.push_back({});
+                        }
+
+                        state = next[i];
+                    }
+
+                    if (outputs_[state].id == no_output)
+                    {
+                        outputs_[state] = {
+                            static_cast<std::uint32_t>(id),
+                            static_cast<std::uint32_t>(p.size()) };
+                    }
+                }
+
+                if (depth_.size() * classes_ > has_output)
+                {
+                    throw std::length_error{ "too many pattern states" };
+                }
+
+                complete(next);
+                first_ = char_class{ firsts };
+
+                transitions_.resize(next.size());
+                for (std::size_t i = 0; i < next.size(); ++i)
+                {
+                    const auto t = next[i];
+                    transitions_[i] =
+                        static_cast<std::uint32_t>(t * classes_) |
+                        (outputs_[t].id != no_output ? has_output : 0);
+                }
+            }
+
+            std::optional<pattern_hit> find(parse_input_t s) const
+            {
+                std::optional<pattern_hit> best;
+                std::uint32_t row = 0;
+
+                for (std::size_t i = 0; i < s.size(); ++i)
+                {
+                    // at the root, skip to the next byte that can start
+                    // a pattern
+                    if (row == 0 && !first_.contains(s[i]))
+                    {
+                        i += scan_until(first_, s.substr(i));
+                        if (i == s.size())
+                        {
+                            break;
+                        }
+                    }
+
+                    const auto t = transitions_[row + class_of(s[i])];
+                    row = t & ~has_output;
+
+                    if ((t & has_output) == 0 && !best)
+                    {
+                        continue;
+                    }
+
+                    const auto state = row / classes_;
+                    if (t & has_output)
+                    {
+                        auto const& out = outputs_[state];
+                        const pattern_hit hit{ i + 1 - out.length, out.length,
+                                               out.id };
+                        if (!best || hit.better_than(*best))
+                        {
+                            best = hit;
+                        }
+                    }
+
+                    // a match found later starts after the best one
+                    if (i + 1 - depth_[state] > best->start)
+                    {
+                        break;
+                    }
+                }
+
+                return best;
+            }
+
+        private:
+            static constexpr std::uint32_t no_output =
+                std::numeric_limits<std::uint32_t>::max();
+
+            // set in a transition to a state that ends a pattern, so the
+            // scan only looks up outputs when there is one
+            static constexpr std::uint32_t has_output = 0x80000000;
+
+            struct output
+            {
+                std::uint32_t id{no_output};
+                std::uint32_t length{0};
+            };
+
+            std::size_t class_of(char ch) const
+            {
+                return class_of_[static_cast<unsigned char>(ch)];
+            }
+
+            // Adds the failure links to the trie in breadth first order,
+            // which turns it into a DFA. The output of a state becomes the
+            // longest pattern that ends there.
+            void complete(std::vector<std::uint32_t>& next)
+            {
+                std::vector<std::uint32_t> fail(depth_.size(), 0);
+                std::vector<std::uint32_t> queue;
+                queue.reserve(depth_.size());
+
+                for (std::size_t c = 0; c < classes_; ++c)
+                {
+                    if (next[c] != 0)
+                    {
+                        queue.push_back(next[c]);
+                    }
+                }
+
+                for (std::size_t q = 0; q < queue.size(); ++q)
+                {
+                    const auto state = queue[q];
+                    if (outputs_[state].id == no_output)
+                    {
+                        outputs_[state] = outputs_[fail[state]];
+                    }
+
+                    for (std::size_t c = 0; c < classes_; ++c)
+                    {
+                        auto& t = next[state * classes_ + c];
+                        const auto f = next[fail[state] * classes_ + c];
+                        if (t != 0)
+                        {
+                            fail[t] = f;
+                            queue.push_back(t);
+                        }
+                        else
+                        {
+                            t = f;
+                        }
+                    }
+                }
+            }
+
+            std::array<std::uint16_t, 256> class_of_{};
+            std::size_t classes_{1};
+
+            // the row offset of the next state, and has_output
+            std::vector<std::uint32_t> transitions_;
+
+            std::vector<output> outputs_;
+            std::vector<std::uint32_t> depth_;
+            char_class first_;
+        };
+
+#if PTCORE_SIMD_X86
+        // Teddy, as in Hyperscan: the patterns are spread over eight
+        // buckets, and nibble lookup tables map each of the first few
+        // bytes of the input to the buckets with a pattern that has that
+        // byte there. Sixteen positions are checked at once with a few
+        // shuffles, and only the candidates are compared in full.
+        class teddy_matcher
+        {
+        public:
+            static constexpr std::size_t max_patterns = 32;
+
+            explicit teddy_matcher(std::vector<std::string> const& patterns)
+            {
+                width_ = 3;
+                for (auto const& p : patterns)
+                {
+                    width_ = std::min(width_, p.size());
+                }
+
+                for (std::size_t id = 0; id < patterns.size(); ++id)
+                {
+                    const auto bucket = id % 8;
+                    buckets_[bucket].push_back(id);
+
+                    for (std::size_t k = 0; k < width_; ++k)
+                    {
+                        const auto b =
+                            static_cast<unsigned char>(patterns[id][k]);
+                        const auto bit =
+                            static_cast<std::uint8_t>(1u << bucket);
+                        low_[k][b & 0x0f] |= bit;
+                        high_[k][b >> 4] |= bit;
+                    }
+                }
+            }
+
+            PTCORE_TARGET("ssse3")
+            std::optional<pattern_hit> find(
+                parse_input_t s, std::vector<std::string> const& patterns) const
+            {
+                const __m128i nibble = _mm_set1_epi8(0x0f);
+                __m128i low[3];
+                __m128i high[3];
+                for (std::size_t k = 0; k < width_; ++k)
+                {
+                    low[k] = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i*>(low_[k].data()));
+                    high[k] = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i*>(high_[k].data()));
+                }
+
+                std::size_t i = 0;
+                for (; i + width_ + 15 <= s.size(); i += 16)
+                {
+                    __m128i buckets = _mm_set1_epi8(-1);
+                    for (std::size_t k = 0; k < width_; ++k)
+                    {
+                        const __m128i v =
+                            _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+                                s.data() + i + k));
+                        const __m128i lo = _mm_shuffle_epi8(
+                            low[k], _mm_and_si128(v, nibble));
+                        const __m128i hi = _mm_shuffle_epi8(
+                            high[k],
+                            _mm_and_si128(_mm_srli_epi16(v, 4), nibble));
+                        buckets = _mm_and_si128(buckets,
+                                                _mm_and_si128(lo, hi));
+                    }
+
+                    auto candidates =
+                        ~static_cast<unsigned>(_mm_movemask_epi8(
+                            _mm_cmpeq_epi8(buckets, _mm_setzero_si128()))) &
+                        0xffffu;
+                    if (candidates == 0)
+                    {
+                        continue;
+                    }
+
+                    alignas(16) std::array<std::uint8_t, 16> masks;
+                    _mm_store_si128(reinterpret_cast<__m128i*>(masks.data()),
+                                    buckets);
+
+                    for (; candidates != 0; candidates &= candidates - 1)
+                    {
+                        const auto j = static_cast<std::size_t>(
+                            std::countr_zero(candidates));
+                        if (const auto hit =
+                                verify(s, i + j, masks[j], patterns))
+                        {
+                            return hit;
+                        }
+                    }
+                }
+
+                // the tail, one position at a time
+                for (; i + width_ <= s.size(); ++i)
+                {
+                    unsigned mask = 0xff;
+                    for (std::size_t k = 0; k < width_; ++k)
+                    {
+                        const auto b = static_cast<unsigned char>(s[i + k]);
+                        mask &= low_[k][b & 0x0f] & high_[k][b >> 4];
+                    }
+
+                    if (mask != 0)
+                    {
+                        if (const auto hit = verify(s, i, mask, patterns))
+                        {
+                            return hit;
+                        }
+                    }
+                }
+
+                return std::nullopt;
+            }
+
+        private:
+            // The lowest id pattern of the buckets in mask that occurs at
+            // pos, if any.
+            std::optional<pattern_hit> verify(
+                parse_input_t s,
+                std::size_t pos,
+                unsigned mask,
+                std::vector<std::string> const& patterns) const
+            {
+                const auto rest = s.substr(pos);
+                std::optional<pattern_hit> ret;
+
+                for (; mask != 0; mask &= mask - 1)
+                {
+                    for (const auto id : buckets_[std::countr_zero(mask)])
+                    {
+                        if (ret && id > ret->id)
+                        {
+                            break;
+                        }
+
+                        if (rest.starts_with(patterns[id]))
+                        {
+                            ret = pattern_hit{ pos, patterns[id].size(), id };
+                            break;
+                        }
+                    }
+                }
+
+                return ret;
+            }
+
+            // the number of leading bytes looked up, at most 3 and at most
+            // the length of the shortest pattern
+            std::size_t width_;
+
+            std::array<std::array<std::uint8_t, 16>, 3> low_{};
+            std::array<std::array<std::uint8_t, 16>, 3> high_{};
+
+            // the ids in each bucket, in increasing order
+            std::array<std::vector<std::size_t>, 8> buckets_;
+        };
+#endif
+
+        struct pattern_set_data
+        {
+            explicit pattern_set_data(std::vector<std::string> p)
+                : patterns{ std::move(p) }, automaton{ patterns }
+            {
+#if PTCORE_SIMD_X86
+                if (!patterns.empty() &&
+                    patterns.size() <= teddy_matcher::max_patterns)
+                {
+                    teddy.emplace(patterns);
+                }
+#endif
+            }
+
+            std::vector<std::string> patterns;
+            pattern_automaton automaton;
+#if PTCORE_SIMD_X86
+            std::optional<teddy_matcher> teddy;
+#endif
+        };
+    }
+
+    // A parser that searches the input for the first occurrence of any of
+    // a set of literal patterns, e.g. the next of many tags or markers.
+    // The match that starts first wins, and of those starting at the same
+    // place, the pattern that comes first in the set. The input up to the
+    // end of the match is consumed.
+    //
+    // Small sets are searched with the SIMD Teddy algorithm, and large
+    // ones, or all of them without SSSE3, with an Aho-Corasick automaton,
+    // so the cost of a search does not grow with the number of patterns.
+    // Building the set is the expensive part, so build it once: copies
+    // share the same immutable matcher, and can be used from any number
+    // of threads.
+    class pattern_set
+    {
+    public:
+        explicit pattern_set(std::initializer_list<std::string_view> patterns)
+            : pattern_set{ std::views::all(patterns) }
+        {
+        }
+
+        // Throws std::invalid_argument if a pattern is empty.
+        template <std::ranges::input_range R>
+        requires std::convertible_to<std::ranges::range_reference_t<R>,
+                                     std::string_view>
+        explicit pattern_set(R&& patterns)
+            : data_{ std::make_shared<const detail::pattern_set_data>(
+                  copy(std::forward<R>(patterns))) }
+        {
+        }
+
+        parse_return_t<pattern_match> operator()(parse_input_t s) const
+        {
+            const auto hit = find(s);
+            if (!hit)
+            {
+                return std::nullopt;
+            }
+
+            return parse_results{
+                pattern_match{ hit->id, s.substr(0, hit->start),
+                               s.substr(hit->start, hit->length) },
+                s.substr(hit->start + hit->length) };
+        }
+
+        recognize_return_t recognize(parse_input_t s) const
+        {
+            if (const auto hit = find(s))
+            {
+                return s.substr(hit->start + hit->length);
+            }
+
+            return std::nullopt;
+        }
+
+        parser_info info() const
+        {
+            std::size_t shortest = parser_info::unbounded;
+            for (auto const& p : data_->patterns)
+            {
+                shortest = std::min(shortest, p.size());
+            }
+
+            return { ~char_class{}, shortest, parser_info::unbounded };
+        }
+
+        std::size_t size() const { return data_->patterns.size(); }
+
+        std::string_view pattern(std::size_t id) const
+        {
+            return data_->patterns[id];
+        }
+
+    private:
+        template <typename R>
+        static std::vector<std::string> copy(R&& patterns)
+        {
+            std::vector<std::string> ret;
+            for (std::string_view p : patterns)
+            {
+                if (p.empty())
+                {
+                    throw std::invalid_argument{ "empty pattern" };
+                }
+
+                ret.emplace_back(p);
+            }
+
+            return ret;
+        }
+
+        std::optional<detail::pattern_hit> find(parse_input_t s) const
+        {
+#if PTCORE_SIMD_X86
+            if (data_->teddy &&
+                detail::cpu_simd_level() != detail::simd_level::scalar)
+            {
+                return data_->teddy->find(s, data_->patterns);
+            }
+#endif
+            return data_->automaton.find(s);
+        }
+
+        std::shared_ptr<const detail::pattern_set_data> data_;
+    };
+}
@@ -0,0 +1,473 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace ptcore
+{
+    // The writing counterpart of a parser: p.print(first, last, v) writes v
+    // as text into [first, last) and returns the end of the text, or
+    // nullptr if it does not fit, and p.max_size(v) bounds the length of
+    // the text. Printers that know the exact length cheaply, without
+    // formatting v, also provide p.size(v), which lets callers size their
+    // output once.
+    template <typename P, typename T>
+    concept printer_for = requires(P const& p, T const& v, char* out) {
+        { p.print(out, out, v) } -> std::same_as<char*>;
+        { p.max_size(v) } -> std::same_as<std::size_t>;
+    };
+
+    template <typename P, typename T>
+    concept sized_printer_for = printer_for<P, T> &&
+        requires(P const& p, T const& v) {
+            { p.size(v) } -> std::same_as<std::size_t>;
+        };
+
+    namespace detail
+    {
+        // The number of decimal digits of v, from its bit width and one
+        // compare against a power of ten.
+        constexpr std::size_t decimal_digits(std::uint64_t v)
+        {
+            constexpr std::uint64_t powers[] = {
+                1ull,
+                10ull,
+                100ull,
+                1000ull,
+                10000ull,
+                100000ull,
+                1000000ull,
+                10000000ull,
+                100000000ull,
+                1000000000ull,
+                10000000000ull,
+                100000000000ull,
+                1000000000000ull,
+                10000000000000ull,
+                100000000000000ull,
+                1000000000000000ull,
+                10000000000000000ull,
+                100000000000000000ull,
+                1000000000000000000ull,
+                10000000000000000000ull
+            };
+
+            // 1233 / 4096 is just above log10(2); v | 1 gives 0 its digit
+            // and has as many digits as v
+            const std::uint64_t w = v | 1;
+            const auto t = (std::bit_width(w) * 1233) >> 12;
+            return static_cast<std::size_t>(t) + (w >= powers[t] ? 1 : 0);
+        }
+
+        template <typename T>
+        struct integer_printer
+        {
+            char* print(char* first, char* last, T v) const
+            {
+                const auto r = std::to_chars(first, last, v);
+                return r.ec == std::errc{} ? r.ptr : nullptr;
+            }
+
+            constexpr std::size_t max_size(T) const
+            {
+                return std::numeric_limits<T>::digits10 + 1 +
+                       (std::is_signed_v<T> ? 1 : 0);
+            }
+
+            constexpr std::size_t size(T v) const
+            {
+                using U = std::make_unsigned_t<T>;
+                if constexpr (std::is_signed_v<T>)
+                {
+                    if (v < 0)
+                    {
+                        return 1 + decimal_digits(U(U(0) - U(v)));
+                    }
+                }
+
+                return decimal_digits(U(v));
+            }
+        };
+
+        template <typename T>
+        struct floating_point_printer
+        {
+            char* print(char* first, char* last, T v) const
+            {
+                const auto r = std::to_chars(first, last, v);
+                return r.ec == std::errc{} ? r.ptr : nullptr;
+            }
+
+            // sign, digits, point, 'e' and the exponent with its sign, e.g.
+            // -2.2250738585072014e-308; subnormals reach max_digits10
+            // decimal places below min_exponent10
+            constexpr std::size_t max_size(T) const
+            {
+                using limits = std::numeric_limits<T>;
+                constexpr int exponent =
+                    limits::max_exponent10 >
+                            limits::max_digits10 - limits::min_exponent10
+                        ? limits::max_exponent10
+                        : limits::max_digits10 - limits::min_exponent10;
+
+                return limits::max_digits10 + 4 +
+                       decimal_digits(static_cast<std::uint64_t>(exponent));
+            }
+        };
+
+        struct char_printer
+        {
+            constexpr char* print(char* first, char* last, char c) const
+            {
+                if (first == last)
+                {
+                    return nullptr;
+                }
+
+                *first = c;
+                return first + 1;
+            }
+
+            constexpr std::size_t max_size(char) const { return 1; }
+            constexpr std::size_t size(char) const { return 1; }
+        };
+
+        constexpr char* write_text(char* first,
+                                   char* last,
+                                   std::string_view s)
+        {
+            if (static_cast<std::size_t>(last - first) < s.size())
+            {
+                return nullptr;
+            }
+
+            for (const char c : s)
+            {
+                *first++ = c;
+            }
+
+            return first;
+        }
+
+        struct text_printer
+        {
+            constexpr char* print(char* first,
+                                  char* last,
+                                  std::string_view s) const
+            {
+                return write_text(first, last, s);
+            }
+
+            constexpr std::size_t max_size(std::string_view s) const
+            {
+                return s.size();
+            }
+
+            constexpr std::size_t size(std::string_view s) const
+            {
+                return s.size();
+            }
+        };
+
+        template <typename... P>
+        struct seq_printer
+        {
+            template <typename... T>
+            requires(sizeof...(T) == sizeof...(P))
+            constexpr char* print(char* first,
+                                  char* last,
+                                  std::tuple<T...> const& v) const
+            {
+                return [&]<std::size_t... I>(std::index_sequence<I...>)
+                {
+                    // stops at the first element that does not fit
+                    ((first = first ? std::get<I>(printers).print(
+                                          first, last, std::get<I>(v))
+                                    : nullptr),
+                     ...);
+                    return first;
+                }(std::index_sequence_for<P...>{});
+            }
+
+            template <typename... T>
+            requires(sizeof...(T) == sizeof...(P))
+            constexpr std::size_t max_size(std::tuple<T...> const& v) const
+            {
+                return [&]<std::size_t... I>(std::index_sequence<I...>)
+                {
+                    return (std::size_t{0} + ... +
+                            std::get<I>(printers).max_size(std::get<I>(v)));
+                }(std::index_sequence_for<P...>{});
+            }
+
+            template <typename... T>
+            requires(sizeof...(T) == sizeof...(P) &&
+                     (sized_printer_for<P, T> && ...))
+            constexpr std::size_t size(std::tuple<T...> const& v) const
+            {
+                return [&]<std::size_t... I>(std::index_sequence<I...>)
+                {
+                    return (std::size_t{0} + ... +
+                            std::get<I>(printers).size(std::get<I>(v)));
+                }(std::index_sequence_for<P...>{});
+            }
+
+            std::tuple<P...> printers;
+        };
+
+        // The elements of a range separated by sep, which is how both
+        // print_n and print_sep_by write.
+        template <typename P>
+        struct sep_by_printer
+        {
+            template <std::ranges::forward_range R>
+            requires printer_for<P, std::ranges::range_value_t<R>>
+            constexpr char* print(char* first, char* last, R const& r) const
+            {
+                bool separate = false;
+                for (auto const& e : r)
+                {
+                    if (separate)
+                    {
+                        first = write_text(first, last, sep);
+                        if (!first)
+                        {
+                            return nullptr;
+                        }
+                    }
+
+                    first = p.print(first, last, e);
+                    if (!first)
+                    {
+                        return nullptr;
+                    }
+
+                    separate = true;
+                }
+
+                return first;
+            }
+
+            template <std::ranges::forward_range R>
+            requires printer_for<P, std::ranges::range_value_t<R>>
+            constexpr std::size_t max_size(R const& r) const
+            {
+                std::size_t ret = 0;
+                for (auto const& e : r)
+                {
+                    ret += p.max_size(e) + sep.size();
+                }
+
+                return ret;
+            }
+
+            template <std::ranges::forward_range R>
+            requires sized_printer_for<P, std::ranges::range_value_t<R>>
+            constexpr std::size_t size(R const& r) const
+            {
+                std::size_t ret = 0;
+                for (auto const& e : r)
+                {
+                    ret += p.size(e) + sep.size();
+                }
+
+                return ret == 0 ? 0 : ret - sep.size();
+            }
+
+            P p;
+            std::string_view sep;
+        };
+
+        // A std::string, which can grow without zero filling the new
+        // characters first.
+        template <typename C>
+        concept overwritable = requires(C& c) {
+            c.resize_and_overwrite(std::size_t{ 0 },
+                                   [](char*, std::size_t n) { return n; });
+        };
+
+        template <std::size_t N, typename P>
+        struct n_printer
+        {
+            template <typename T>
+            constexpr char* print(char* first,
+                                  char* last,
+                                  std::array<T, N> const& v) const
+            {
+                return elements.print(first, last, v);
+            }
+
+            template <typename T>
+            constexpr std::size_t max_size(std::array<T, N> const& v) const
+            {
+                return elements.max_size(v);
+            }
+
+            template <typename T>
+            requires sized_printer_for<P, T>
+            constexpr std::size_t size(std::array<T, N> const& v) const
+            {
+                return elements.size(v);
+            }
+
+            sep_by_printer<P> elements;
+        };
+    }
+
+    // Writes an integer in decimal with std::to_chars, the inverse of
+    // match_integer<T>().
+    template <std::integral T>
+    requires(!std::same_as<T, bool>)
+    constexpr auto print_integer()
+    {
+        return detail::integer_printer<T>{};
+    }
+
+    // Writes the shortest text that match_floating_point<T>() reads back
+    // as the same value, with std::to_chars.
+    template <std::floating_point T>
+    constexpr auto print_floating_point()
+    {
+        return detail::floating_point_printer<T>{};
+    }
+
+    // Writes a char, the inverse of match_char.
+    constexpr auto print_char()
+    {
+        return detail::char_printer{};
+    }
+
+    // Writes a std::string_view as it is, the inverse of parsers that give
+    // the matched input, such as match_run.
+    constexpr auto print_text()
+    {
+        return detail::text_printer{};
+    }
+
+    // Writes the elements of a tuple with ps in turn, the inverse of
+    // seq(ps...).
+    template <typename... P>
+    requires(sizeof...(P) > 0)
+    constexpr auto print_seq(P... ps)
+    {
+        return detail::seq_printer<P...>{ { std::move(ps)... } };
+    }
+
+    // Writes the N elements of a std::array with p, separated by sep, the
+    // inverse of match_n<N>(p, sep).
+    template <std::size_t N, typename P>
+    requires(N > 0)
+    constexpr auto print_n(P p, std::string_view sep)
+    {
+        return detail::n_printer<N, P>{ { std::move(p), sep } };
+    }
+
+    // Writes the elements of a range with p, separated by sep, the inverse
+    // of sep_by(p, sep).
+    template <typename P>
+    constexpr auto print_sep_by(P p, std::string_view sep)
+    {
+        return detail::sep_by_printer<P>{ std::move(p), sep };
+    }
+
+    // Writes v into buffer, returning the length of the text, or nullopt
+    // if it does not fit.
+    template <typename P, typename T>
+    requires printer_for<P, T>
+    constexpr std::optional<std::size_t> print_to(P const& p,
+                                                  std::span<char> buffer,
+                                                  T const& v)
+    {
+        // an empty span can have a null data(), which print would return
+        // for empty text
+        char none;
+        char* const first = buffer.empty() ? &none : buffer.data();
+
+        char* const end = p.print(first, first + buffer.size(), v);
+        if (!end)
+        {
+            return std::nullopt;
+        }
+
+        return static_cast<std::size_t>(end - first);
+    }
+
+    // Appends v to out, a std::string or vector of char, including their
+    // std::pmr forms for output kept in an arena. out grows once, by the
+    // exact length where p knows it and by p.max_size(v) otherwise, and is
+    // then written in place; a std::string is not zero filled first.
+    //
+    // Throws std::length_error, with out as it was, if the text is longer
+    // than p said it could be.
+    template <typename P, typename T, typename Container>
+    requires printer_for<P, T> &&
+             std::same_as<typename Container::value_type, char>
+    void print_append(P const& p, Container& out, T const& v)
+    {
+        std::size_t n;
+        if constexpr (sized_printer_for<P, T>)
+        {
+            n = p.size(v);
+        }
+        else
+        {
+            n = p.max_size(v);
+        }
+
+        if (n == 0)
+        {
+            return;
+        }
+
+        const std::size_t old_size = out.size();
+        std::size_t new_size = old_size;
+        bool fits = false;
+        const auto write = [&](char* data)
+        {
+            if (char* const end = p.print(data + old_size,
+                                          data + old_size + n, v))
+            {
+                new_size = static_cast<std::size_t>(end - data);
+                fits = true;
+            }
+        };
+
+        if constexpr (detail::overwritable<Container>)
+        {
+            // the operation must not throw, so a failure is only noted
+            out.resize_and_overwrite(old_size + n,
+                                     [&](char* data, std::size_t)
+                                     {
+                                         write(data);
+                                         return new_size;
+                                     });
+        }
+        else
+        {
+            out.resize(old_size + n);
+            write(out.data());
+            out.resize(new_size);
+        }
+
+        if (!fits)
+        {
+            throw std::length_error{
+                "print_append: text longer than the printer's bound"
+            };
+        }
+    }
+}
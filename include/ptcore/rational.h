@@ -0,0 +1,397 @@
+#pragma once
+
+#include <bit>
+#include <compare>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <ratio>
+#include <stdexcept>
+#include <type_traits>
+
+#include "ptcore/parser.h"
+#include "ptcore/char_class.h"
+#include "ptcore/numeric.h"
+#include "ptcore/ratio.h"
+#include "ptcore/detail/int128.h"
+
+namespace ptcore
+{
+    namespace detail
+    {
+        // Stein's algorithm: common factors of two are taken out with a
+        // single count of trailing zeros, and the rest only subtracts and
+        // shifts, without the divisions of Euclid's.
+        template <std::unsigned_integral U>
+        constexpr U binary_gcd(U a, U b)
+        {
+            if (a == 0)
+            {
+                return b;
+            }
+
+            if (b == 0)
+            {
+                return a;
+            }
+
+            const int shift = std::countr_zero(U(a | b));
+            a >>= std::countr_zero(a);
+            do
+            {
+                b >>= std::countr_zero(b);
+                if (a > b)
+                {
+                    const U t = a;
+                    a = b;
+                    b = t;
+                }
+
+                b -= a;
+            } while (b != 0);
+
+            return static_cast<U>(a << shift);
+        }
+
+        // A signed type that holds the product of any two Int values.
+        template <typename Int>
+        struct rational_wide;
+
+        template <typename Int>
+        requires(sizeof(Int) <= sizeof(std::int32_t))
+        struct rational_wide<Int>
+        {
+            using type = std::int64_t;
+        };
+
+        template <typename Int>
+        requires(sizeof(Int) == sizeof(std::int64_t))
+        struct rational_wide<Int>
+        {
+#if PTCORE_INT128
+            __extension__ using type = __int128;
+#else
+            using type = int128;
+#endif
+        };
+
+        template <typename Int>
+        concept rational_integer =
+            std::signed_integral<Int> &&
+            requires { typename rational_wide<Int>::type; };
+
+        template <typename R, typename Int>
+        concept ratio_within = ratio<R> &&
+            R::num >= std::numeric_limits<Int>::min() &&
+            R::num <= std::numeric_limits<Int>::max() &&
+            R::den <= std::numeric_limits<Int>::max();
+    }
+
+    // A fraction of two Int values, kept in lowest terms with a positive
+    // denominator, so equal values have equal members. Arithmetic is exact:
+    // intermediate products are formed in an integer twice as wide, and
+    // std::overflow_error is thrown if the reduced result does not fit in
+    // Int.
+    //
+    // Every std::ratio whose terms fit in Int converts to a rational, and
+    // compares with one, exactly. Arithmetic with a std::ratio operand
+    // uses its terms as constants, which skips the reductions they make
+    // unnecessary, e.g. every one for adding an integer.
+    template <detail::rational_integer Int = std::intmax_t>
+    class rational
+    {
+        using wide_t = typename detail::rational_wide<Int>::type;
+        using unsigned_t = std::make_unsigned_t<Int>;
+
+    public:
+        using value_type = Int;
+
+        constexpr rational() = default;
+
+        constexpr rational(Int n) : num_{ n } {}
+
+        // Throws std::invalid_argument if d is zero, and
+        // std::overflow_error if the reduced fraction does not fit in Int,
+        // as with n = min and d = -1.
+        constexpr rational(Int n, Int d)
+        {
+            if (d == 0)
+            {
+                throw std::invalid_argument{ "rational: zero denominator" };
+            }
+
+            const auto g = detail::binary_gcd(magnitude(n), magnitude(d));
+            wide_t wn = wide_t{ n } / g;
+            wide_t wd = wide_t{ d } / g;
+            if (wd < 0)
+            {
+                wn = -wn;
+                wd = -wd;
+            }
+
+            num_ = narrow(wn);
+            den_ = narrow(wd);
+        }
+
+        template <detail::ratio_within<Int> R>
+        constexpr rational(R)
+            : num_{ static_cast<Int>(R::num) },
+              den_{ static_cast<Int>(R::den) }
+        {
+        }
+
+        constexpr Int num() const { return num_; }
+        constexpr Int den() const { return den_; }
+
+        template <std::floating_point F>
+        constexpr explicit operator F() const
+        {
+            return static_cast<F>(num_) / static_cast<F>(den_);
+        }
+
+        friend constexpr bool operator==(rational, rational) = default;
+
+        friend constexpr std::strong_ordering operator<=>(rational a,
+                                                          rational b)
+        {
+            return wide_t{ a.num_ } * b.den_ <=> wide_t{ b.num_ } * a.den_;
+        }
+
+        constexpr rational operator+() const { return *this; }
+
+        constexpr rational operator-() const
+        {
+            return make(narrow(-wide_t{ num_ }), den_);
+        }
+
+        friend constexpr rational operator+(rational a, rational b)
+        {
+            return add(a.num_, a.den_, b.num_, b.den_);
+        }
+
+        friend constexpr rational operator-(rational a, rational b)
+        {
+            return add(a.num_, a.den_, -wide_t{ b.num_ }, b.den_);
+        }
+
+        friend constexpr rational operator*(rational a, rational b)
+        {
+            return multiply(a.num_, a.den_, b.num_, b.den_);
+        }
+
+        // Throws std::domain_error if b is zero.
+        friend constexpr rational operator/(rational a, rational b)
+        {
+            if (b.num_ == 0)
+            {
+                throw std::domain_error{ "rational: division by zero" };
+            }
+
+            return multiply(a.num_, a.den_, b.den_, b.num_);
+        }
+
+        template <detail::ratio_within<Int> R>
+        friend constexpr rational operator+(rational a, R)
+        {
+            if constexpr (R::den == 1)
+            {
+                // a.num + k * a.den shares no factor with a.den
+                return make(narrow(wide_t{ a.num_ } + wide_t{ R::num } *
+                                                        a.den_),
+                            a.den_);
+            }
+            else
+            {
+                return a + rational{ R{} };
+            }
+        }
+
+        template <detail::ratio_within<Int> R>
+        friend constexpr rational operator+(R r, rational a)
+        {
+            return a + r;
+        }
+
+        template <detail::ratio_within<Int> R>
+        friend constexpr rational operator-(rational a, R)
+        {
+            return a + std::ratio<-R::num, R::den>{};
+        }
+
+        template <detail::ratio_within<Int> R>
+        friend constexpr rational operator-(R r, rational a)
+        {
+            return rational{ r } - a;
+        }
+
+        template <detail::ratio_within<Int> R>
+        friend constexpr rational operator*(rational a, R)
+        {
+            // a and R are both in lowest terms, so only a.num and R::den,
+            // and R::num and a.den, can share factors
+            wide_t n = a.num_;
+            wide_t d = a.den_;
+            unsigned_t g1 = 1;
+            unsigned_t g2 = 1;
+            if constexpr (R::den != 1)
+            {
+                g1 = detail::binary_gcd(magnitude(a.num_),
+                                        static_cast<unsigned_t>(R::den));
+            }
+
+            if constexpr (R::num != 1 && R::num != -1)
+            {
+                g2 = detail::binary_gcd(
+                    static_cast<unsigned_t>(R::num < 0 ? -R::num : R::num),
+                    magnitude(a.den_));
+            }
+
+            n = n / g1 * (R::num / static_cast<wide_t>(g2));
+            d = d / g2 * (R::den / static_cast<wide_t>(g1));
+            return make(narrow(n), narrow(d));
+        }
+
+        template <detail::ratio_within<Int> R>
+        friend constexpr rational operator*(R r, rational a)
+        {
+            return a * r;
+        }
+
+        template <detail::ratio_within<Int> R>
+        requires(R::num != 0)
+        friend constexpr rational operator/(rational a, R)
+        {
+            return a * std::ratio<R::den, R::num>{};
+        }
+
+        constexpr rational& operator+=(rational b) { return *this = *this + b; }
+        constexpr rational& operator-=(rational b) { return *this = *this - b; }
+        constexpr rational& operator*=(rational b) { return *this = *this * b; }
+        constexpr rational& operator/=(rational b) { return *this = *this / b; }
+
+    private:
+        static constexpr unsigned_t magnitude(Int v)
+        {
+            return v < 0 ? static_cast<unsigned_t>(
+                               unsigned_t(0) - static_cast<unsigned_t>(v))
+                         : static_cast<unsigned_t>(v);
+        }
+
+        static constexpr Int narrow(wide_t v)
+        {
+            if (v < std::numeric_limits<Int>::min() ||
+                v > std::numeric_limits<Int>::max())
+            {
+                throw std::overflow_error{ "rational: overflow" };
+            }
+
+            return static_cast<Int>(v);
+        }
+
+        // n / d already in lowest terms, with d positive
+        static constexpr rational make(Int n, Int d)
+        {
+            rational ret;
+            ret.num_ = n;
+            ret.den_ = d;
+            return ret;
+        }
+
+        // Knuth's addition: gcd(d1, d2) is usually 1, and the only
+        // further reduction needed is by a divisor of it.
+        static constexpr rational add(Int n1, Int d1, wide_t n2, Int d2)
+        {
+            const auto g = detail::binary_gcd(magnitude(d1), magnitude(d2));
+            const wide_t t = wide_t{ n1 } * (d2 / static_cast<Int>(g)) +
+                             n2 * (d1 / static_cast<Int>(g));
+            if (g == 1)
+            {
+                return make(narrow(t), narrow(wide_t{ d1 } * d2));
+            }
+
+            const auto t_mod_g = static_cast<unsigned_t>(
+                (t < 0 ? -t : t) % static_cast<wide_t>(g));
+            const auto g2 = static_cast<wide_t>(
+                detail::binary_gcd(t_mod_g, g));
+
+            return make(narrow(t / g2),
+                        narrow(wide_t{ d1 / static_cast<Int>(g) } *
+                               (d2 / g2)));
+        }
+
+        // Cross reduction: with both operands in lowest terms, the result
+        // is too once n1 and d2, and n2 and d1, have no common factor. d2
+        // may be negative, for a division.
+        static constexpr rational multiply(Int n1, Int d1, Int n2, Int d2)
+        {
+            const auto g1 = static_cast<wide_t>(
+                detail::binary_gcd(magnitude(n1), magnitude(d2)));
+            const auto g2 = static_cast<wide_t>(
+                detail::binary_gcd(magnitude(n2), magnitude(d1)));
+            wide_t n = n1 / g1 * (n2 / g2);
+            wide_t d = d1 / g2 * (d2 / g1);
+            if (d < 0)
+            {
+                n = -n;
+                d = -d;
+            }
+
+            return make(narrow(n), narrow(d));
+        }
+
+        Int num_{0};
+        Int den_{1};
+    };
+
+    template <ratio R>
+    rational(R) -> rational<std::intmax_t>;
+
+    namespace detail
+    {
+        template <typename Int>
+        struct rational_parser
+        {
+            constexpr parse_return_t<rational<Int>> operator()(
+                parse_input_t s) const
+            {
+                const auto n = match_integer<Int>()(s);
+                if (!n)
+                {
+                    return std::nullopt;
+                }
+
+                s = n->remaining_input;
+                if (s.empty() || s.front() != '/')
+                {
+                    return parse_results{ rational<Int>{ n->value }, s };
+                }
+
+                const auto d = match_integer<Int>()(s.substr(1));
+                if (!d || d->value <= 0)
+                {
+                    return std::nullopt;
+                }
+
+                // the only fraction of two Int values without a reduced
+                // form in Int has a negative denominator
+                return parse_results{ rational<Int>{ n->value, d->value },
+                                      d->remaining_input };
+            }
+
+            constexpr parser_info info() const
+            {
+                return { char_classes::digit | char_class{ "-" }, 1,
+                         parser_info::unbounded };
+            }
+        };
+    }
+
+    // Matches an integer, optionally followed by '/' and a positive
+    // denominator, e.g. "-3/4", giving the fraction in lowest terms.
+    template <detail::rational_integer Int = std::intmax_t>
+    constexpr auto match_rational()
+    {
+        return detail::rational_parser<Int>{};
+    }
+}
@@ -0,0 +1,265 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <memory_resource>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ptcore/parser.h"
+#include "ptcore/inline_vector.h"
+
+namespace ptcore
+{
+    namespace detail
+    {
+        struct no_separator
+        {
+            constexpr parse_return_t<parse_input_t> operator()(
+                parse_input_t s) const
+            {
+                return parse_results{ s.substr(0, 0), s };
+            }
+
+            constexpr parser_info info() const
+            {
+                return { char_class{}, 0, 0 };
+            }
+        };
+
+        // Appends up to max values of p (separated by sep) to out and
+        // returns the remaining input, or nullopt if fewer than min values
+        // matched. A separator is only consumed if a value follows it, and
+        // the loop stops after a value that consumed no input.
+        template <typename P, typename Separator, typename Container>
+        constexpr std::optional<parse_input_t> repeat_into(P const& p,
+                                                           Separator const& sep,
+                                                           parse_input_t s,
+                                                           std::size_t min,
+                                                           std::size_t max,
+                                                           Container& out)
+        {
+            std::size_t count = 0;
+            while (count < max)
+            {
+                auto next = s;
+                if (count > 0)
+                {
+                    const auto r = sep(next);
+                    if (!r)
+                    {
+                        break;
+                    }
+                    next = r->remaining_input;
+                }
+
+                auto r = p(next);
+                if (!r)
+                {
+                    break;
+                }
+
+                out.push_back(std::move(r->value));
+                ++count;
+
+                const bool progressed = r->remaining_input.size() < s.size();
+                s = r->remaining_input;
+                if (!progressed)
+                {
+                    break;
+                }
+            }
+
+            if (count < min)
+            {
+                return std::nullopt;
+            }
+
+            return s;
+        }
+
+        inline constexpr std::size_t unbounded =
+            std::numeric_limits<std::size_t>::max();
+
+        // The recognize mode counterpart of repeat_into: the same remaining
+        // input, without building any values.
+        template <typename P, typename Separator>
+        constexpr recognize_return_t repeat_recognize(P const& p,
+                                                      Separator const& sep,
+                                                      parse_input_t s,
+                                                      std::size_t min,
+                                                      std::size_t max)
+        {
+            std::size_t count = 0;
+            while (count < max)
+            {
+                recognize_return_t next = s;
+                if (count > 0)
+                {
+                    next = ptcore::recognize(sep, s);
+                    if (!next)
+                    {
+                        break;
+                    }
+                }
+
+                const auto r = ptcore::recognize(p, *next);
+                if (!r)
+                {
+                    break;
+                }
+
+                ++count;
+
+                const bool progressed = r->size() < s.size();
+                s = *r;
+                if (!progressed)
+                {
+                    break;
+                }
+            }
+
+            if (count < min)
+            {
+                return std::nullopt;
+            }
+
+            return s;
+        }
+
+        template <std::size_t Min,
+                  std::size_t Max,
+                  typename P,
+                  typename Separator = no_separator>
+        struct inline_repeat_parser
+        {
+            using vector_t = inline_vector<parser_parse_type<P const&>, Max>;
+
+            constexpr parse_return_t<vector_t> operator()(parse_input_t s) const
+            {
+                vector_t ret;
+                if (const auto rest = repeat_into(p, sep, s, Min, Max, ret))
+                {
+                    return parse_results{ std::move(ret), *rest };
+                }
+
+                return std::nullopt;
+            }
+
+            constexpr recognize_return_t recognize(parse_input_t s) const
+            {
+                return repeat_recognize(p, sep, s, Min, Max);
+            }
+
+            // Only fewer than Min matches fail, so the walk stops there.
+            constexpr bool incomplete(parse_input_t s) const
+            {
+                sequence_walk w{ s };
+                for (std::size_t i = 0; i < Min; ++i)
+                {
+                    if ((i > 0 && !w.step(sep)) || !w.step(p))
+                    {
+                        break;
+                    }
+                }
+
+                return w.result;
+            }
+
+            constexpr parser_info info() const
+            {
+                const auto p_info = ptcore::info(p);
+                const auto sep_info = ptcore::info(sep);
+                const auto most = repeat_info(p_info, sep_info, Max);
+
+                return { most.first,
+                         repeat_info(p_info, sep_info, Min).min_length,
+                         most.max_length };
+            }
+
+            P p;
+            Separator sep{};
+        };
+
+        template <typename P, typename Separator = no_separator>
+        struct pmr_repeat_parser
+        {
+            using vector_t = std::pmr::vector<parser_parse_type<P const&>>;
+
+            parse_return_t<vector_t> operator()(parse_input_t s) const
+            {
+                vector_t ret{ mr };
+                const auto rest = repeat_into(p, sep, s, 0, unbounded, ret);
+                return parse_results{ std::move(ret), *rest };
+            }
+
+            constexpr recognize_return_t recognize(parse_input_t s) const
+            {
+                return repeat_recognize(p, sep, s, 0, unbounded);
+            }
+
+            constexpr parser_info info() const
+            {
+                // two matches already start with every byte that any
+                // longer repetition can
+                const auto two = repeat_info(ptcore::info(p),
+                                             ptcore::info(sep), 2);
+                return { two.first, 0, parser_info::unbounded };
+            }
+
+            P p;
+            Separator sep;
+            std::pmr::memory_resource* mr;
+        };
+    }
+
+    // Matches p at least Min and at most Max times, collecting the values
+    // inline.
+    template <std::size_t Min, std::size_t Max, parser P>
+    requires(Min <= Max && Max > 0)
+    constexpr auto repeat(P&& p)
+    {
+        return detail::inline_repeat_parser<Min, Max, std::remove_cvref_t<P>>{
+            std::forward<P>(p) };
+    }
+
+    // Matches p zero or more times, up to Capacity, collecting the values
+    // inline.
+    template <std::size_t Capacity, parser P>
+    constexpr auto many(P&& p)
+    {
+        return repeat<0, Capacity>(std::forward<P>(p));
+    }
+
+    // Matches p zero or more times, collecting the values into a vector
+    // that allocates from mr.
+    template <parser P>
+    auto many(P&& p, std::pmr::memory_resource* mr)
+    {
+        return detail::pmr_repeat_parser<std::remove_cvref_t<P>>{
+            std::forward<P>(p), {}, mr };
+    }
+
+    // Matches zero or more p separated by sep, up to Capacity, collecting
+    // the values inline.
+    template <std::size_t Capacity, parser P, parser Separator>
+    requires(Capacity > 0)
+    constexpr auto sep_by(P&& p, Separator&& sep)
+    {
+        return detail::inline_repeat_parser<0, Capacity, std::remove_cvref_t<P>,
+                                            std::remove_cvref_t<Separator>>{
+            std::forward<P>(p), std::forward<Separator>(sep) };
+    }
+
+    // Matches zero or more p separated by sep, collecting the values into a
+    // vector that allocates from mr.
+    template <parser P, parser Separator>
+    auto sep_by(P&& p, Separator&& sep, std::pmr::memory_resource* mr)
+    {
+        return detail::pmr_repeat_parser<std::remove_cvref_t<P>,
+                                         std::remove_cvref_t<Separator>>{
+            std::forward<P>(p), std::forward<Separator>(sep), mr };
+    }
+}
@@ -0,0 +1,295 @@
+#pragma once
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+#include "ptcore/numeric.h"
+#include "ptcore/ratio.h"
+#include "ptcore/detail/simd.h"
+
+namespace ptcore
+{
+    // How scale rounds a quotient that is not exact.
+    enum class rounding
+    {
+        toward_zero,
+        floor,
+        ceil,
+        // ties away from zero
+        nearest
+    };
+
+    namespace detail
+    {
+        // Division of any W bit unsigned value by the constant d as a
+        // multiply-high, a subtract and two shifts (Granlund and Montgomery,
+        // "Division by Invariant Integers using Multiplication", 1994):
+        //
+        //     t = mulhi(x, multiplier)
+        //     x / d = (t + ((x - t) >> shift_1)) >> shift_2
+        //
+        // The multiplier is computed here, once, at compile time.
+        template <std::unsigned_integral W>
+        struct reciprocal
+        {
+            static constexpr int bits = std::numeric_limits<W>::digits;
+
+            constexpr explicit reciprocal(W d)
+            {
+                const int l = std::bit_width(W(d - 1));
+
+                // floor(2^bits * (2^l - d) / d) + 1, by long division,
+                // as 2^l can itself be out of range
+                const W a = l == bits ? W(-d) : W((W{1} << l) - d);
+                W r = a;
+                W q = 0;
+                for (int i = 0; i < bits; ++i)
+                {
+                    const bool carry = (r >> (bits - 1)) != 0;
+                    r = W(r << 1);
+                    q = W(q << 1);
+                    if (carry || r >= d)
+                    {
+                        r = W(r - d);
+                        q |= 1;
+                    }
+                }
+
+                multiplier = W(q + 1);
+                shift_1 = l > 0 ? 1 : 0;
+                shift_2 = l > 0 ? l - 1 : 0;
+            }
+
+            constexpr W divide(W x) const
+            {
+                W t;
+                if constexpr (bits == 64)
+                {
+                    t = full_multiplication(x, multiplier).high;
+                }
+                else
+                {
+                    t = W((std::uint64_t{x} * multiplier) >> bits);
+                }
+
+                return W((t + W(W(x - t) >> shift_1)) >> shift_2);
+            }
+
+            W multiplier;
+            int shift_1;
+            int shift_2;
+        };
+
+        template <typename R>
+        inline constexpr std::uint64_t ratio_num_magnitude =
+            static_cast<std::uint64_t>(R::num < 0 ? -R::num : R::num);
+
+        // x * num / den is computed as (x / den) * num + (x % den) * num
+        // / den, which never needs a product wider than the input, provided
+        // (den - 1) * num fits in W.
+        template <typename R, typename W>
+        concept ratio_scalable_in = ratio<R> &&
+            (R::den == 1 ||
+             ratio_num_magnitude<R> <=
+                 std::numeric_limits<W>::max() /
+                     static_cast<std::uint64_t>(R::den - 1));
+
+        template <typename R, std::unsigned_integral W>
+        struct scale_constants
+        {
+            static constexpr W num = static_cast<W>(ratio_num_magnitude<R>);
+            static constexpr W den = static_cast<W>(R::den);
+            static constexpr reciprocal<W> by_den{ den };
+
+            // the smallest remainder that rounds to nearest away from zero
+            static constexpr W half = den - den / 2;
+        };
+
+        // The magnitude of x * R rounded as Mode says, where negative is
+        // the sign of the result.
+        template <typename R, rounding Mode, std::unsigned_integral W>
+        constexpr W scale_magnitude(W x, bool negative)
+        {
+            using k = scale_constants<R, W>;
+
+            const W q = k::by_den.divide(x);
+            const W r = W(W(x - q * k::den) * k::num);
+            const W q2 = k::by_den.divide(r);
+            const W rem = W(r - q2 * k::den);
+
+            W ret = W(q * k::num + q2);
+            if constexpr (Mode == rounding::floor)
+            {
+                ret += negative && rem != 0;
+            }
+            else if constexpr (Mode == rounding::ceil)
+            {
+                ret += !negative && rem != 0;
+            }
+            else if constexpr (Mode == rounding::nearest)
+            {
+                ret += rem >= k::half;
+            }
+
+            return ret;
+        }
+
+#if PTCORE_SIMD_X86
+        // The high 32 bits of the products of the unsigned lanes of a and b.
+        PTCORE_TARGET("avx2")
+        inline __m256i mulhi_epu32(__m256i a, __m256i b)
+        {
+            const __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(a, b), 32);
+            const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32),
+                                                 _mm256_srli_epi64(b, 32));
+            return _mm256_blend_epi32(even, odd, 0xaa);
+        }
+
+        PTCORE_TARGET("avx2")
+        inline __m256i divide_epu32(__m256i x, reciprocal<std::uint32_t> r)
+        {
+            const __m256i t = mulhi_epu32(
+                x, _mm256_set1_epi32(static_cast<int>(r.multiplier)));
+            const __m256i sum = _mm256_add_epi32(
+                t, _mm256_srl_epi32(_mm256_sub_epi32(x, t),
+                                    _mm_cvtsi32_si128(r.shift_1)));
+            return _mm256_srl_epi32(sum, _mm_cvtsi32_si128(r.shift_2));
+        }
+
+        // scale_magnitude for eight 32 bit lanes at once, with the sign
+        // applied back to the result.
+        template <typename R, rounding Mode, bool Signed>
+        PTCORE_TARGET("avx2")
+        void scale_avx2(const std::uint32_t* in,
+                        std::uint32_t* out,
+                        std::size_t n)
+        {
+            using k = scale_constants<R, std::uint32_t>;
+
+            const __m256i num = _mm256_set1_epi32(static_cast<int>(k::num));
+            const __m256i den = _mm256_set1_epi32(static_cast<int>(k::den));
+            const __m256i flip =
+                _mm256_set1_epi32(R::num < 0 ? -1 : 0);
+            const __m256i zero = _mm256_setzero_si256();
+
+            for (std::size_t i = 0; i < n; i += 8)
+            {
+                const __m256i x = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(in + i));
+
+                // all ones in the lanes whose result is negative
+                __m256i negative = flip;
+                __m256i magnitude = x;
+                if constexpr (Signed)
+                {
+                    negative =
+                        _mm256_xor_si256(_mm256_srai_epi32(x, 31), flip);
+                    magnitude = _mm256_abs_epi32(x);
+                }
+
+                const __m256i q = divide_epu32(magnitude, k::by_den);
+                const __m256i r = _mm256_mullo_epi32(
+                    _mm256_sub_epi32(magnitude, _mm256_mullo_epi32(q, den)),
+                    num);
+                const __m256i q2 = divide_epu32(r, k::by_den);
+                const __m256i rem =
+                    _mm256_sub_epi32(r, _mm256_mullo_epi32(q2, den));
+
+                __m256i ret =
+                    _mm256_add_epi32(_mm256_mullo_epi32(q, num), q2);
+
+                // all ones in the lanes that round away from zero
+                __m256i up = zero;
+                const __m256i inexact = _mm256_xor_si256(
+                    _mm256_cmpeq_epi32(rem, zero), _mm256_set1_epi32(-1));
+                if constexpr (Mode == rounding::floor)
+                {
+                    up = _mm256_and_si256(inexact, negative);
+                }
+                else if constexpr (Mode == rounding::ceil)
+                {
+                    up = _mm256_andnot_si256(negative, inexact);
+                }
+                else if constexpr (Mode == rounding::nearest)
+                {
+                    const __m256i half =
+                        _mm256_set1_epi32(static_cast<int>(k::half));
+                    up = _mm256_cmpeq_epi32(_mm256_max_epu32(rem, half), rem);
+                }
+
+                ret = _mm256_sub_epi32(ret, up);
+                ret = _mm256_sub_epi32(_mm256_xor_si256(ret, negative),
+                                       negative);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), ret);
+            }
+        }
+#endif
+    }
+
+    // x * R, rounded as Mode says, as a U, or a T if U is void. Like
+    // duration_cast, the result is not checked against the range of U.
+    template <ratio R, rounding Mode = rounding::toward_zero,
+              typename U = void, std::integral T>
+    requires detail::ratio_scalable_in<R, std::uint64_t> &&
+             (std::is_void_v<U> || std::integral<U>)
+    constexpr auto scale(T x)
+    {
+        using result_t = std::conditional_t<std::is_void_v<U>, T, U>;
+        using W = std::uint64_t;
+
+        bool negative = R::num < 0;
+        W magnitude = static_cast<W>(x);
+        if constexpr (std::is_signed_v<T>)
+        {
+            negative ^= x < 0;
+            if (x < 0)
+            {
+                magnitude = W(0) - magnitude;
+            }
+        }
+
+        const W ret = detail::scale_magnitude<R, Mode>(magnitude, negative);
+        return static_cast<result_t>(negative ? W(0) - ret : ret);
+    }
+
+    // out[i] = scale<R, Mode>(in[i]) for every element of in, with no
+    // division instruction: R::den is divided by with a multiplier
+    // computed at compile time. Between 32 bit types, where R allows the
+    // computation in 32 bits, eight elements are scaled at a time with
+    // AVX2. Throws std::length_error if out is shorter than in.
+    template <ratio R, rounding Mode = rounding::toward_zero,
+              std::integral T, std::integral U>
+    requires detail::ratio_scalable_in<R, std::uint64_t>
+    void scale(std::span<const T> in, std::span<U> out)
+    {
+        if (out.size() < in.size())
+        {
+            throw std::length_error{ "scale: output is too short" };
+        }
+
+        std::size_t i = 0;
+#if PTCORE_SIMD_X86
+        if constexpr (sizeof(T) == 4 && sizeof(U) == 4 &&
+                      detail::ratio_scalable_in<R, std::uint32_t>)
+        {
+            if (detail::cpu_simd_level() == detail::simd_level::avx2)
+            {
+                i = in.size() - in.size() % 8;
+                detail::scale_avx2<R, Mode, std::is_signed_v<T>>(
+                    reinterpret_cast<const std::uint32_t*>(in.data()),
+                    reinterpret_cast<std::uint32_t*>(out.data()), i);
+            }
+        }
+#endif
+        for (; i < in.size(); ++i)
+        {
+            out[i] = scale<R, Mode, U>(in[i]);
+        }
+    }
+}
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include "ptcore/parser.h"
+
+namespace ptcore
+{
+    namespace detail
+    {
+        // Makes a parser move assignable, as views must be, by
+        // reconstructing it in place. Lambdas with captures need this.
+        template <typename T>
+        class movable_box
+        {
+        public:
+            constexpr explicit movable_box(T v)
+                : v_{ std::in_place, std::move(v) }
+            {
+            }
+
+            constexpr movable_box(movable_box&&) = default;
+
+            constexpr movable_box& operator=(movable_box&& other)
+            {
+                if (this != &other)
+                {
+                    v_.reset();
+                    v_.emplace(std::move(*other.v_));
+                }
+
+                return *this;
+            }
+
+            constexpr T const& operator*() const { return *v_; }
+
+        private:
+            std::optional<T> v_;
+        };
+    }
+
+    // The elements of s matched by p and separated by sep, parsed one at
+    // a time as the view is iterated. Like std::ranges::istream_view it is
+    // a single pass input range, and an element is only parsed when it is
+    // read, so s | std::views::take(n) parses n elements and no more.
+    //
+    // After the iteration ends, remaining_input() is the input after the
+    // last element, and failed() tells whether it ended because p did not
+    // match where an element was expected. The view holds the parse state,
+    // so it is move only; iterate std::ranges::ref_view{ v } to still read
+    // the state of v after a pipeline.
+    template <typename P, typename Separator>
+    class separated_view
+        : public std::ranges::view_interface<separated_view<P, Separator>>
+    {
+    public:
+        using value_type = parser_parse_type<P const&>;
+
+        class iterator
+        {
+        public:
+            using iterator_concept = std::input_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = separated_view::value_type;
+
+            constexpr explicit iterator(separated_view& parent)
+                : parent_{ &parent }
+            {
+            }
+
+            iterator(iterator&&) = default;
+            iterator& operator=(iterator&&) = default;
+
+            constexpr value_type& operator*() const
+            {
+                parent_->update();
+                return *parent_->value_;
+            }
+
+            constexpr iterator& operator++()
+            {
+                parent_->pending_ = true;
+                return *this;
+            }
+
+            constexpr void operator++(int) { ++*this; }
+
+            constexpr bool operator==(std::default_sentinel_t) const
+            {
+                parent_->update();
+                return !parent_->value_;
+            }
+
+        private:
+            separated_view* parent_;
+        };
+
+        constexpr separated_view(P p, Separator sep, parse_input_t s)
+            : p_{ std::move(p) }, sep_{ std::move(sep) }, remaining_{ s }
+        {
+        }
+
+        separated_view(separated_view&&) = default;
+        separated_view& operator=(separated_view&&) = default;
+
+        // Precondition: begin() has not been called before.
+        constexpr iterator begin() { return iterator{ *this }; }
+
+        constexpr std::default_sentinel_t end() const noexcept
+        {
+            return std::default_sentinel;
+        }
+
+        // The input after the last element parsed so far.
+        constexpr parse_input_t remaining_input() const { return remaining_; }
+
+        // Whether the iteration ended because p did not match, at the
+        // start of the input or after a separator.
+        constexpr bool failed() const { return failed_; }
+
+    private:
+        // Parses the next element if the iterator has been advanced since
+        // the last one was read.
+        constexpr void update()
+        {
+            if (!pending_)
+            {
+                return;
+            }
+
+            pending_ = false;
+            value_.reset();
+
+            if (done_)
+            {
+                return;
+            }
+
+            auto next = remaining_;
+            if (started_)
+            {
+                const auto r = (*sep_)(next);
+                if (!r)
+                {
+                    done_ = true;
+                    return;
+                }
+
+                next = r->remaining_input;
+            }
+
+            auto r = (*p_)(next);
+            if (!r)
+            {
+                failed_ = true;
+                done_ = true;
+                return;
+            }
+
+            // an element and separator that consume nothing would repeat
+            // forever, so that element is the last one
+            done_ = started_ && r->remaining_input.size() == remaining_.size();
+            started_ = true;
+
+            remaining_ = r->remaining_input;
+            value_.emplace(std::move(r->value));
+        }
+
+        detail::movable_box<P> p_;
+        detail::movable_box<Separator> sep_;
+        parse_input_t remaining_;
+
+        std::optional<value_type> value_;
+        bool pending_{true};
+        bool started_{false};
+        bool done_{false};
+        bool failed_{false};
+    };
+
+    // A lazy view of the p values in s separated by sep.
+    template <parser P, parser Separator>
+    constexpr auto separated(P&& p, Separator&& sep, parse_input_t s)
+    {
+        return separated_view<std::remove_cvref_t<P>,
+                              std::remove_cvref_t<Separator>>{
+            std::forward<P>(p), std::forward<Separator>(sep), s };
+    }
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "ptcore/parser.h"
+#include "ptcore/detail/simd.h"
+
+namespace ptcore
+{
+    // Describes a single byte separator for indexed parsing. Separators
+    // between a pair of quote characters are not structural; an escape
+    // character makes the next byte (quote, separator or escape) literal.
+    struct structural_separator
+    {
+        char separator;
+        std::optional<char> quote{};
+        std::optional<char> escape{};
+    };
+
+    namespace detail
+    {
+        // Inclusive prefix xor: bit i is the parity of bits [0, i] of x.
+        constexpr std::uint64_t prefix_xor(std::uint64_t x)
+        {
+            x ^= x << 1;
+            x ^= x << 2;
+            x ^= x << 4;
+            x ^= x << 8;
+            x ^= x << 16;
+            x ^= x << 32;
+            return x;
+        }
+
+        // Bits of the bytes that follow an odd length run of escape
+        // characters. carry holds whether the first byte of the next block
+        // is escaped.
+        constexpr std::uint64_t escaped_bits(std::uint64_t escapes,
+                                             std::uint64_t& carry)
+        {
+            constexpr std::uint64_t even_bits = 0x5555555555555555;
+
+            escapes &= ~carry;
+            const std::uint64_t follows_escape = (escapes << 1) | carry;
+            const std::uint64_t odd_starts =
+                escapes & ~even_bits & ~follows_escape;
+
+            const std::uint64_t sum = odd_starts + escapes;
+            carry = sum < odd_starts ? 1 : 0;
+
+            const std::uint64_t invert = sum << 1;
+            return (even_bits ^ invert) & follows_escape;
+        }
+    }
+
+    // Stage one of a two stage parse: a single vectorized pass over the
+    // input that records the offset of every structural separator, so that
+    // fields can then be parsed independently of each other.
+    class separator_index
+    {
+    public:
+        separator_index() = default;
+
+        separator_index(parse_input_t s, structural_separator sep)
+            : input_{ s }
+        {
+            positions_.reserve(s.size() / 16);
+
+            std::uint64_t escape_carry = 0;
+            std::uint64_t in_quote_carry = 0;
+
+            for (std::size_t base = 0; base < s.size(); base += 64)
+            {
+                const char* block = s.data() + base;
+                const std::size_t n = std::min<std::size_t>(64, s.size() - base);
+
+                char tail[64];
+                std::uint64_t valid = ~std::uint64_t{0};
+                if (n < 64)
+                {
+                    std::memset(tail, 0, sizeof(tail));
+                    std::memcpy(tail, block, n);
+                    block = tail;
+                    valid = (std::uint64_t{1} << n) - 1;
+                }
+
+                std::uint64_t structural =
+                    detail::eq_mask64(block, sep.separator) & valid;
+
+                std::uint64_t escaped = 0;
+                if (sep.escape)
+                {
+                    escaped = detail::escaped_bits(
+                        detail::eq_mask64(block, *sep.escape) & valid,
+                        escape_carry);
+                    structural &= ~escaped;
+                }
+
+                if (sep.quote)
+                {
+                    const std::uint64_t quotes =
+                        detail::eq_mask64(block, *sep.quote) & valid & ~escaped;
+                    const std::uint64_t in_quote =
+                        detail::prefix_xor(quotes) ^ in_quote_carry;
+
+                    structural &= ~in_quote;
+                    in_quote_carry = (in_quote >> 63) != 0 ? ~std::uint64_t{0}
+                                                           : std::uint64_t{0};
+                }
+
+                while (structural != 0)
+                {
+                    positions_.push_back(
+                        base + static_cast<std::size_t>(
+                                   std::countr_zero(structural)));
+                    structural &= structural - 1;
+                }
+            }
+        }
+
+        parse_input_t input() const { return input_; }
+
+        // Offsets of the structural separators, in increasing order.
+        std::span<const std::size_t> positions() const { return positions_; }
+
+        std::size_t field_count() const { return positions_.size() + 1; }
+
+        // The text between separator i - 1 and separator i.
+        parse_input_t field(std::size_t i) const
+        {
+            const std::size_t first = i == 0 ? 0 : positions_[i - 1] + 1;
+            const std::size_t last =
+                i == positions_.size() ? input_.size() : positions_[i];
+            return input_.substr(first, last - first);
+        }
+
+    private:
+        parse_input_t input_;
+        std::vector<std::size_t> positions_;
+    };
+
+    // Stage two: the same result as match_n_count(p, sep, s) for a single
+    // byte separator, with p run on each indexed field. p must not consume
+    // a separator byte.
+    template <parser P>
+    match_n_count_result match_n_count(P&& p, separator_index const& index)
+    {
+        match_n_count_result ret;
+
+        const auto n = index.field_count();
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const auto r = recognize(p, index.field(i));
+            if (!r)
+            {
+                break;
+            }
+
+            ++ret.count;
+            if (!r->empty())
+            {
+                break;
+            }
+
+            if (i + 1 == n)
+            {
+                ret.full_match = true;
+            }
+        }
+
+        return ret;
+    }
+
+    template <parser P>
+    match_n_count_result match_n_count(P&& p,
+                                       structural_separator sep,
+                                       parse_input_t s)
+    {
+        return match_n_count(std::forward<P>(p), separator_index{ s, sep });
+    }
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+#include "ptcore/parser.h"
+#include "ptcore/combinators.h"
+
+// Tables that are parsed while the program compiles. The text comes from a
+// source, a captureless lambda returning it as a std::string_view, e.g.
+//
+//     static constexpr char units_text[] = {
+//     #embed "units.txt"
+//     };
+//
+//     constexpr auto units = ptcore::parse_static_map<[] {
+//         return std::string_view{ units_text, sizeof(units_text) };
+//     }>(ptcore::match_run(ptcore::char_classes::alpha),
+//        ptcore::match_char('='), ptcore::match_integer<int>());
+//
+// Each non-blank line of the text is a row that must match the grammar
+// as a whole. The result is a constant, so it is stored in read-only data
+// and nothing is parsed at startup. Values that refer to the text, such as
+// the std::string_view of match_run, point into the source's storage,
+// which must be static.
+//
+// A row that does not parse is a compile error, as is a table beyond the
+// limits, which keep a mistaken table from running into the compiler's
+// own step limit with a less helpful message.
+namespace ptcore
+{
+    struct static_table_limits
+    {
+        std::size_t max_rows{ 4096 };
+        std::size_t max_bytes{ 256 * 1024 };
+    };
+
+    // A map sorted by key and searched by binary search.
+    template <typename K, typename V, std::size_t N>
+    struct static_map
+    {
+        using value_type = std::pair<K, V>;
+
+        constexpr const V* find(K const& key) const
+        {
+            const auto it = std::lower_bound(
+                entries.begin(), entries.end(), key,
+                [](value_type const& e, K const& k) { return e.first < k; });
+            if (it == entries.end() || key < it->first)
+            {
+                return nullptr;
+            }
+
+            return &it->second;
+        }
+
+        constexpr bool contains(K const& key) const
+        {
+            return find(key) != nullptr;
+        }
+
+        static constexpr std::size_t size() { return N; }
+
+        constexpr auto begin() const { return entries.begin(); }
+        constexpr auto end() const { return entries.end(); }
+
+        std::array<value_type, N> entries;
+    };
+
+    namespace detail
+    {
+        template <typename F>
+        concept static_text_source = requires(F const& f) {
+            { f() } -> std::convertible_to<std::string_view>;
+        };
+
+        constexpr bool blank_line(std::string_view line)
+        {
+            return line.find_first_not_of(" \t\r") == line.npos;
+        }
+
+        constexpr std::size_t count_rows(std::string_view s)
+        {
+            std::size_t ret = 0;
+            while (!s.empty())
+            {
+                const auto end = std::min(s.find('\n'), s.size());
+                ret += !blank_line(s.substr(0, end));
+                s.remove_prefix(std::min(end + 1, s.size()));
+            }
+
+            return ret;
+        }
+
+        // Not constexpr: reaching one during constant evaluation is the
+        // compile error, which names it.
+        inline void static_table_row_does_not_parse() {}
+        inline void static_table_duplicate_key() {}
+    }
+
+    // The rows of the text of Source, parsed by p, in the order they
+    // appear.
+    template <auto Source, static_table_limits Limits = {}, parser P>
+    requires detail::static_text_source<decltype(Source)>
+    consteval auto parse_static_rows(P const& p)
+    {
+        constexpr std::string_view text = Source();
+        static_assert(text.size() <= Limits.max_bytes,
+                      "static table text is larger than max_bytes of "
+                      "its static_table_limits");
+
+        constexpr std::size_t n = detail::count_rows(text);
+        static_assert(n <= Limits.max_rows,
+                      "static table has more rows than max_rows of its "
+                      "static_table_limits");
+
+        std::array<parser_parse_type<P const&>, n> ret{};
+        std::size_t i = 0;
+        std::string_view rest = text;
+        while (!rest.empty())
+        {
+            const auto end = std::min(rest.find('\n'), rest.size());
+            auto line = rest.substr(0, end);
+            rest.remove_prefix(std::min(end + 1, rest.size()));
+            if (detail::blank_line(line))
+            {
+                continue;
+            }
+
+            if (line.back() == '\r')
+            {
+                line.remove_suffix(1);
+            }
+
+            parse_cursor c{ line };
+            if (!ptcore::parse_into(p, c, ret[i]) || !c.empty())
+            {
+                detail::static_table_row_does_not_parse();
+            }
+
+            ++i;
+        }
+
+        return ret;
+    }
+
+    // The rows of the text of Source, parsed by p, sorted, for lookups with
+    // std::binary_search and std::equal_range.
+    template <auto Source, static_table_limits Limits = {}, parser P>
+    requires detail::static_text_source<decltype(Source)>
+    consteval auto parse_static_sorted(P const& p)
+    {
+        auto ret = parse_static_rows<Source, Limits>(p);
+        std::sort(ret.begin(), ret.end());
+        return ret;
+    }
+
+    // A map of the rows of the text of Source, each a key and a value
+    // separated by sep. A key on two rows is a compile error.
+    template <auto Source, static_table_limits Limits = {}, parser Key,
+              parser Separator, parser Value>
+    requires detail::static_text_source<decltype(Source)>
+    consteval auto parse_static_map(Key const& key,
+                                    Separator const& sep,
+                                    Value const& value)
+    {
+        const auto rows =
+            parse_static_rows<Source, Limits>(seq(key, sep, value));
+
+        using key_type = parser_parse_type<Key const&>;
+        using mapped_type = parser_parse_type<Value const&>;
+        constexpr std::size_t n = std::tuple_size_v<decltype(rows)>;
+        static_map<key_type, mapped_type, n> ret{};
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            ret.entries[i] = { std::get<0>(rows[i]), std::get<2>(rows[i]) };
+        }
+
+        const auto by_key = [](auto const& a, auto const& b)
+        {
+            return a.first < b.first;
+        };
+
+        std::sort(ret.entries.begin(), ret.entries.end(), by_key);
+        if (std::adjacent_find(ret.entries.begin(), ret.entries.end(),
+                               [&](auto const& a, auto const& b)
+                               { return !by_key(a, b); }) !=
+            ret.entries.end())
+        {
+            detail::static_table_duplicate_key();
+        }
+
+        return ret;
+    }
+}
@@ -0,0 +1,250 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "ptcore/parser.h"
+
+namespace ptcore
+{
+    enum class parse_status
+    {
+        // a value was parsed
+        complete,
+
+        // the available input ends inside a value; feed() the next chunk,
+        // or finish() if there is none
+        need_more_input,
+
+        // the input does not match
+        failed,
+
+        // finish() was called and all the input was parsed
+        end_of_input
+    };
+
+    struct stream_options
+    {
+        // a value that takes more than this many bytes to recognize is
+        // reported as a failure instead of growing the carry buffer
+        // any further
+        std::size_t max_token_size{std::size_t{1} << 16};
+    };
+
+    // Parses a stream of back to back p values from input that arrives in
+    // chunks. Values that lie within a chunk are parsed in place; only a
+    // value that spans two chunks is assembled in a carry buffer, which
+    // grows with the longest such value rather than with the stream.
+    //
+    // A match that reaches the end of the available input could continue
+    // in the next chunk, so it is only accepted once more input arrives,
+    // the stream is finished, or it reaches p's maximum length. Likewise
+    // a failure waits for more input only if ptcore::incomplete(p, text)
+    // says the input ended too soon; a mismatch before the end fails at
+    // once, without copying what follows.
+    //
+    //     stream_parser sp{ seq(match_integer<int>(), match_char('\n')) };
+    //     for (;;)
+    //     {
+    //         switch (sp.next())
+    //         {
+    //             case parse_status::complete:
+    //                 use(sp.value());
+    //                 break;
+    //             case parse_status::need_more_input:
+    //                 if (const auto chunk = read_chunk(); !chunk.empty())
+    //                     sp.feed(chunk);
+    //                 else
+    //                     sp.finish();
+    //                 break;
+    //             ...
+    //         }
+    //     }
+    template <parser P>
+    class stream_parser
+    {
+    public:
+        using value_type = parser_parse_type<P const&>;
+
+        explicit stream_parser(P p, stream_options opts = {})
+            : p_{ std::move(p) }, info_{ ptcore::info(p_) }, opts_{ opts }
+        {
+        }
+
+        // Supplies the next chunk of input. It must stay valid until next()
+        // returns need_more_input again. Precondition: the last call to
+        // next() returned need_more_input, or there was none.
+        void feed(parse_input_t chunk) { chunk_ = chunk; }
+
+        // Marks the end of the input.
+        void finish() { finished_ = true; }
+
+        parse_status next()
+        {
+            value_.reset();
+            compact_carry();
+
+            if (carry_.empty())
+            {
+                return next_in_chunk();
+            }
+
+            return next_in_carry();
+        }
+
+        // The last parsed value, which may refer to the current chunk or
+        // to the carry buffer. Valid until the next call to next().
+        value_type& value() { return *value_; }
+        value_type const& value() const { return *value_; }
+
+        // Bytes currently held in the carry buffer.
+        std::size_t carry_size() const { return carry_.size(); }
+
+    private:
+        // Whether the result r of parsing text, which is followed by more
+        // input only if more is true, can be trusted.
+        template <typename R>
+        bool decided(R const& r, parse_input_t text, bool more) const
+        {
+            if (!more)
+            {
+                return true;
+            }
+
+            if (r)
+            {
+                return !r->remaining_input.empty() ||
+                       text.size() >= info_.max_length;
+            }
+
+            return !ptcore::incomplete(p_, text);
+        }
+
+        parse_status accept(auto& r, parse_input_t text)
+        {
+            if (!r || r->remaining_input.size() == text.size())
+            {
+                // a match that consumes nothing would never advance
+                return parse_status::failed;
+            }
+
+            value_.emplace(std::move(r->value));
+            return parse_status::complete;
+        }
+
+        parse_status next_in_chunk()
+        {
+            if (chunk_.empty())
+            {
+                return finished_ ? parse_status::end_of_input
+                                 : parse_status::need_more_input;
+            }
+
+            auto r = p_(chunk_);
+            if (decided(r, chunk_, !finished_))
+            {
+                const auto text = chunk_;
+                if (r)
+                {
+                    chunk_ = r->remaining_input;
+                }
+
+                return accept(r, text);
+            }
+
+            if (chunk_.size() > opts_.max_token_size)
+            {
+                return parse_status::failed;
+            }
+
+            carry_.assign(chunk_);
+            chunk_ = {};
+            return parse_status::need_more_input;
+        }
+
+        // carry_[carry_pos_, end) holds the start of a value followed by
+        // copies of the first appended_ bytes of chunk_.
+        parse_status next_in_carry()
+        {
+            for (;;)
+            {
+                const parse_input_t text = carry_;
+                const bool all_copied = appended_ == chunk_.size();
+
+                auto r = p_(text);
+                if (decided(r, text, !(all_copied && finished_)))
+                {
+                    if (r)
+                    {
+                        const auto consumed =
+                            text.size() - r->remaining_input.size();
+                        const auto tail = carry_.size() - appended_;
+                        if (consumed >= tail)
+                        {
+                            chunk_.remove_prefix(consumed - tail);
+                            appended_ = 0;
+                            carry_pos_ = carry_.size();
+                        }
+                        else
+                        {
+                            carry_pos_ = consumed;
+                        }
+                    }
+
+                    return accept(r, text);
+                }
+
+                if (carry_.size() >= opts_.max_token_size)
+                {
+                    return parse_status::failed;
+                }
+
+                if (all_copied)
+                {
+                    // all of chunk_ is in the carry now
+                    chunk_ = {};
+                    appended_ = 0;
+                    return parse_status::need_more_input;
+                }
+
+                // double the carry each time, so a long value is parsed
+                // a logarithmic number of times
+                const auto n =
+                    std::min(chunk_.size() - appended_,
+                             std::max<std::size_t>(carry_.size(), 16));
+                carry_.append(chunk_.substr(appended_, n));
+                appended_ += n;
+            }
+        }
+
+        // Drops the part of the carry that was parsed by the previous call,
+        // and the whole carry once it only holds copies of chunk_ bytes.
+        void compact_carry()
+        {
+            carry_.erase(0, carry_pos_);
+            carry_pos_ = 0;
+
+            if (carry_.size() == appended_)
+            {
+                carry_.clear();
+                appended_ = 0;
+            }
+        }
+
+        P p_;
+        parser_info info_;
+        stream_options opts_;
+
+        parse_input_t chunk_;
+        std::string carry_;
+        std::size_t carry_pos_{0};
+        std::size_t appended_{0};
+        bool finished_{false};
+
+        std::optional<value_type> value_;
+    };
+}
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "ptcore/parser.h"
+#include "ptcore/char_parsers.h"
+#include "ptcore/detail/simd.h"
+#include "ptcore/detail/utf8_validate.h"
+
+namespace ptcore
+{
+    // The length of the longest prefix of s that is valid UTF-8, which is
+    // s.size() exactly when all of s is. The check runs 16 or 32 bytes at
+    // a time where SSSE3 or AVX2 is available.
+    constexpr std::size_t validate_utf8(parse_input_t s)
+    {
+        if consteval
+        {
+            return detail::validate_utf8_scalar(s, 0);
+        }
+        else
+        {
+#if PTCORE_SIMD_X86
+            switch (detail::cpu_simd_level())
+            {
+                case detail::simd_level::avx2:
+                    return detail::validate_utf8_avx2(s);
+                case detail::simd_level::ssse3:
+                    return detail::validate_utf8_ssse3(s);
+                case detail::simd_level::scalar:
+                    break;
+            }
+#endif
+            return detail::validate_utf8_scalar(s, 0);
+        }
+    }
+
+    constexpr bool is_valid_utf8(parse_input_t s)
+    {
+        return validate_utf8(s) == s.size();
+    }
+
+    struct decoded_code_point
+    {
+        char32_t value{0};
+
+        // the number of bytes of the sequence, 0 if it is invalid
+        std::size_t length{0};
+    };
+
+    // Decodes the code point at the front of s.
+    constexpr decoded_code_point decode_utf8(parse_input_t s)
+    {
+        const auto length = detail::utf8_sequence_length(s);
+        if (length == 0)
+        {
+            return {};
+        }
+
+        constexpr unsigned char lead_bits[] = { 0, 0x7f, 0x1f, 0x0f, 0x07 };
+        char32_t value = static_cast<unsigned char>(s[0]) & lead_bits[length];
+        for (std::size_t i = 1; i < length; ++i)
+        {
+            value = (value << 6) | (static_cast<unsigned char>(s[i]) & 0x3f);
+        }
+
+        return { value, length };
+    }
+
+    // Accepts every code point.
+    struct any_code_point
+    {
+        constexpr bool operator()(char32_t) const { return true; }
+    };
+
+    // Accepts the code points from first to last.
+    struct code_point_range
+    {
+        constexpr bool operator()(char32_t c) const
+        {
+            return c >= first && c <= last;
+        }
+
+        char32_t first;
+        char32_t last;
+    };
+
+    namespace detail
+    {
+        inline constexpr char_class ascii =
+            char_class::range('\0', '\x7f');
+
+        // the bytes that can start a multi byte sequence
+        inline constexpr char_class utf8_leads =
+            char_class::range('\xc2', '\xf4');
+
+        struct valid_utf8_parser
+        {
+            constexpr parse_return_t<parse_input_t> operator()(
+                parse_input_t s) const
+            {
+                const auto n = validate_utf8(s);
+                return parse_results{ s.substr(0, n), s.substr(n) };
+            }
+
+            constexpr parser_info info() const { return {}; }
+        };
+
+        // A set of code points: the ASCII members of ascii, and the
+        // others for which pred is true.
+        template <typename Pred>
+        struct code_point_set
+        {
+            constexpr bool contains(char32_t c) const
+            {
+                return c < 0x80 ? ascii.contains(static_cast<char>(c))
+                                : static_cast<bool>(pred(c));
+            }
+
+            // The bytes a member can start with.
+            constexpr char_class first() const
+            {
+                return ascii | detail::utf8_leads;
+            }
+
+            char_class ascii;
+            Pred pred;
+        };
+
+        template <typename Pred>
+        struct code_point_parser
+        {
+            constexpr parse_return_t<char32_t> operator()(
+                parse_input_t s) const
+            {
+                const auto c = decode_utf8(s);
+                if (c.length == 0 || !set.contains(c.value))
+                {
+                    return std::nullopt;
+                }
+
+                return parse_results{ c.value, s.substr(c.length) };
+            }
+
+            constexpr parser_info info() const { return { set.first(), 1, 4 }; }
+
+            code_point_set<Pred> set;
+        };
+
+        // The longest run of members of set. Runs of ASCII are matched
+        // with a SIMD char_class scan; a code point is only decoded where
+        // that scan stops at a byte outside ASCII.
+        template <typename Pred>
+        struct code_point_run_parser
+        {
+            constexpr parse_return_t<parse_input_t> operator()(
+                parse_input_t s) const
+            {
+                std::size_t n = 0;
+                std::size_t count = 0;
+                for (;;)
+                {
+                    const auto run = scan_while(set.ascii, s.substr(n));
+                    n += run;
+                    count += run;
+
+                    if (n == s.size() ||
+                        static_cast<unsigned char>(s[n]) < 0x80)
+                    {
+                        break;
+                    }
+
+                    const auto c = decode_utf8(s.substr(n));
+                    if (c.length == 0 || !set.pred(c.value))
+                    {
+                        break;
+                    }
+
+                    n += c.length;
+                    ++count;
+                }
+
+                if (count < min_count)
+                {
+                    return std::nullopt;
+                }
+
+                return parse_results{ s.substr(0, n), s.substr(n) };
+            }
+
+            constexpr parser_info info() const
+            {
+                return { set.first(), min_count, parser_info::unbounded };
+            }
+
+            code_point_set<Pred> set;
+            std::size_t min_count;
+        };
+    }
+
+    // Matches the longest valid UTF-8 prefix of the input; never fails.
+    // match_entirety(valid_utf8()) accepts only input that is valid as a
+    // whole.
+    constexpr auto valid_utf8()
+    {
+        return detail::valid_utf8_parser{};
+    }
+
+    // Matches a single UTF-8 encoded code point, giving its value.
+    constexpr auto match_code_point()
+    {
+        return detail::code_point_parser<any_code_point>{
+            { detail::ascii, {} } };
+    }
+
+    // Matches a code point that is either an ASCII member of ascii or
+    // outside ASCII and accepted by pred.
+    template <typename Pred = any_code_point>
+    requires std::is_invocable_r_v<bool, Pred const&, char32_t>
+    constexpr auto match_code_point(char_class ascii, Pred pred = {})
+    {
+        return detail::code_point_parser<Pred>{
+            { ascii & detail::ascii, std::move(pred) } };
+    }
+
+    // Matches one or more code points that are ASCII members of ascii or
+    // outside ASCII and accepted by pred, e.g. the letters of a script:
+    //
+    //     match_code_point_run(char_classes::alpha,
+    //                          code_point_range{ U'Α', U'ω' })
+    template <typename Pred = any_code_point>
+    requires std::is_invocable_r_v<bool, Pred const&, char32_t>
+    constexpr auto match_code_point_run(char_class ascii, Pred pred = {})
+    {
+        return detail::code_point_run_parser<Pred>{
+            { ascii & detail::ascii, std::move(pred) }, 1 };
+    }
+}
@@ -0,0 +1,224 @@
+#include <doctest/doctest.h>
+#include "ptcore/async.h"
+#include "ptcore/char_parsers.h"
+#include "ptcore/combinators.h"
+#include "ptcore/numeric.h"
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#if PTCORE_HAS_EPOLL
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+    struct pipe_fds
+    {
+        pipe_fds()
+        {
+            REQUIRE(::pipe2(fds, O_NONBLOCK | O_CLOEXEC) == 0);
+        }
+
+        ~pipe_fds()
+        {
+            ::close(fds[0]);
+            close_write();
+        }
+
+        int read_end() const { return fds[0]; }
+
+        // Called from the writer thread as well, so it retries instead of
+        // using REQUIRE when the pipe is full.
+        void write(std::string_view s)
+        {
+            while (!s.empty())
+            {
+                if (const auto n = ::write(fds[1], s.data(), s.size()); n > 0)
+                {
+                    s.remove_prefix(static_cast<std::size_t>(n));
+                }
+            }
+        }
+
+        void close_write()
+        {
+            if (fds[1] >= 0)
+            {
+                ::close(fds[1]);
+                fds[1] = -1;
+            }
+        }
+
+        int fds[2];
+    };
+
+    const auto line =
+        ptcore::seq(ptcore::match_integer<int>(), ptcore::match_char('\n'));
+
+    ptcore::async_task sum_lines(ptcore::event_loop& loop,
+                                 int fd,
+                                 std::vector<int>& out)
+    {
+        auto values = ptcore::parse_fd(loop, fd, line, { .chunk_size = 3 });
+        while (const auto v = co_await values.next())
+        {
+            out.push_back(std::get<0>(*v));
+        }
+    }
+
+    // Destroys victim once the first value arrives.
+    ptcore::async_task destroy_on_first(
+        ptcore::event_loop& loop,
+        int fd,
+        std::optional<ptcore::async_task>& victim)
+    {
+        auto values = ptcore::parse_fd(loop, fd, line);
+        if (co_await values.next())
+        {
+            victim.reset();
+        }
+    }
+}
+
+TEST_CASE("parse_fd")
+{
+    ptcore::event_loop loop;
+
+    SUBCASE("many streams on one thread")
+    {
+        constexpr int streams = 8;
+        constexpr int lines = 50;
+
+        std::vector<pipe_fds> pipes(streams);
+        std::vector<std::vector<int>> results(streams);
+        std::vector<ptcore::async_task> tasks;
+        for (int i = 0; i < streams; ++i)
+        {
+            tasks.push_back(sum_lines(loop, pipes[i].read_end(), results[i]));
+        }
+
+        // all of them are now waiting for data
+        for (auto const& t : tasks)
+        {
+            REQUIRE(!t.done());
+        }
+
+        std::jthread writer{ [&]
+        {
+            for (int n = 0; n < lines; ++n)
+            {
+                for (int i = 0; i < streams; ++i)
+                {
+                    // split lines over writes, so values span reads
+                    const auto text = std::to_string(n * streams + i) + "\n";
+                    pipes[i].write(text.substr(0, 1));
+                    pipes[i].write(text.substr(1));
+                }
+            }
+
+            for (auto& p : pipes)
+            {
+                p.close_write();
+            }
+        } };
+
+        loop.run();
+
+        for (int i = 0; i < streams; ++i)
+        {
+            CAPTURE(i);
+
+            REQUIRE(tasks[i].done());
+            tasks[i].get();
+
+            REQUIRE(results[i].size() == lines);
+            for (int n = 0; n < lines; ++n)
+            {
+                REQUIRE(results[i][n] == n * streams + i);
+            }
+        }
+    }
+
+    SUBCASE("input that does not match")
+    {
+        pipe_fds pipe;
+        std::vector<int> result;
+        auto task = sum_lines(loop, pipe.read_end(), result);
+
+        pipe.write("1\n2\nx\n");
+        pipe.close_write();
+        loop.run();
+
+        REQUIRE(task.done());
+        REQUIRE(result == std::vector{ 1, 2 });
+        REQUIRE_THROWS_AS(task.get(), std::system_error);
+    }
+
+    SUBCASE("input that does not match fails before end of file")
+    {
+        pipe_fds pipe;
+        std::vector<int> result;
+        auto task = sum_lines(loop, pipe.read_end(), result);
+
+        pipe.write("1\n2x\n3\n");
+        loop.run();
+
+        REQUIRE(task.done());
+        REQUIRE(result == std::vector{ 1 });
+        REQUIRE_THROWS_AS(task.get(), std::system_error);
+    }
+
+    SUBCASE("destroying a waiting coroutine withdraws its wait")
+    {
+        pipe_fds pipe;
+        std::vector<int> result;
+        std::optional<ptcore::async_task> task{ std::in_place,
+                                                sum_lines(loop,
+                                                          pipe.read_end(),
+                                                          result) };
+        task.reset();
+
+        // its fd becoming readable resumes nothing, and run() does not
+        // wait for it
+        pipe.write("1\n2\n");
+        pipe_fds other;
+        std::vector<int> other_result;
+        auto other_task = sum_lines(loop, other.read_end(), other_result);
+        other.write("7\n");
+        other.close_write();
+        loop.run();
+
+        REQUIRE(other_task.done());
+        other_task.get();
+        REQUIRE(other_result == std::vector{ 7 });
+        REQUIRE(result.empty());
+    }
+
+    SUBCASE("destroying a coroutine whose event is pending")
+    {
+        pipe_fds a;
+        pipe_fds b;
+        std::vector<int> b_result;
+        std::optional<ptcore::async_task> victim{ std::in_place,
+                                                  sum_lines(loop,
+                                                            b.read_end(),
+                                                            b_result) };
+        auto task = destroy_on_first(loop, a.read_end(), victim);
+
+        // both fds are ready in the same epoll_wait, so the victim may be
+        // destroyed after its event was taken but before it is handled
+        a.write("1\n2\n");
+        b.write("5\n");
+        loop.run();
+
+        REQUIRE(task.done());
+        task.get();
+        REQUIRE(!victim);
+    }
+}
+#endif
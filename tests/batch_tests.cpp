@@ -0,0 +1,99 @@
+#include <doctest/doctest.h>
+#include "ptcore/batch.h"
+#include "ptcore/char_parsers.h"
+#include "ptcore/combinators.h"
+#include "ptcore/numeric.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+    std::vector<std::string> random_fields(std::size_t count)
+    {
+        std::mt19937 rng{ 19 };
+        const std::string_view alphabet = "0123456789012345678901234567-x /";
+
+        std::vector<std::string> ret;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            std::string field;
+            const auto length = rng() % 24;
+            for (std::size_t j = 0; j < length; ++j)
+            {
+                // mostly digits, so most fields match
+                field += alphabet[rng() % (i % 4 == 0 ? alphabet.size() : 10)];
+            }
+            ret.push_back(field);
+        }
+
+        return ret;
+    }
+
+    // Checks parse_batch against match_entirety(p) one input at a time.
+    template <typename P>
+    void check_batch(P const& p, std::vector<std::string> const& fields)
+    {
+        using T = ptcore::parser_parse_type<P const&>;
+
+        const std::vector<ptcore::parse_input_t> inputs(fields.begin(),
+                                                        fields.end());
+        std::vector<T> values(inputs.size());
+        const auto matched = std::make_unique<bool[]>(inputs.size());
+
+        const auto count = ptcore::parse_batch(
+            p, inputs, { values, { matched.get(), inputs.size() } });
+
+        std::size_t expected_count = 0;
+        for (std::size_t i = 0; i < inputs.size(); ++i)
+        {
+            CAPTURE(inputs[i]);
+
+            const auto r = ptcore::match_entirety(p)(inputs[i]);
+            REQUIRE(matched[i] == r.has_value());
+            if (r)
+            {
+                REQUIRE(values[i] == r->value);
+                ++expected_count;
+            }
+        }
+
+        CHECK(count == expected_count);
+    }
+}
+
+TEST_CASE("parse_batch")
+{
+    const auto fields = random_fields(5000);
+
+    check_batch(ptcore::match_integer<std::uint8_t>(), fields);
+    check_batch(ptcore::match_integer<std::uint16_t>(), fields);
+    check_batch(ptcore::match_integer<std::uint32_t>(), fields);
+    check_batch(ptcore::match_integer<std::uint64_t>(), fields);
+    check_batch(ptcore::match_integer<int>(), fields);
+    check_batch(ptcore::seq(ptcore::match_integer<int>(),
+                            ptcore::match_char('/'),
+                            ptcore::match_integer<unsigned>()),
+                fields);
+
+    SUBCASE("edge cases")
+    {
+        const std::vector<std::string> edge = {
+            "", "0", "00000000000000000", "9999999999999999",
+            "18446744073709551615", "18446744073709551616",
+            "4294967295", "4294967296", "65535", "65536", "255", "256",
+            "12 ", " 12", "1x", "+1", "0000000000000001"
+        };
+
+        check_batch(ptcore::match_integer<std::uint8_t>(), edge);
+        check_batch(ptcore::match_integer<std::uint16_t>(), edge);
+        check_batch(ptcore::match_integer<std::uint32_t>(), edge);
+        check_batch(ptcore::match_integer<std::uint64_t>(), edge);
+    }
+}
@@ -0,0 +1,21 @@
+#include <doctest/doctest.h>
+#include "ptcore/char_class.h"
+
+TEST_CASE("char_class")
+{
+    using ptcore::char_class;
+    namespace cc = ptcore::char_classes;
+
+    SUBCASE("membership")
+    {
+        static_assert(char_class{}.empty());
+        static_assert(cc::digit.size() == 10);
+        static_assert(cc::digit.contains('0') && cc::digit.contains('9'));
+        static_assert(!cc::digit.contains('a'));
+        static_assert(cc::identifier.contains('_'));
+        static_assert(char_class::range('\x80', '\xff').size() == 128);
+        static_assert((~cc::digit).size() == 246);
+        static_assert((cc::alnum & cc::digit) == cc::digit);
+        static_assert((cc::alpha | cc::digit) == cc::alnum);
+    }
+}
@@ -0,0 +1,88 @@
+#include <doctest/doctest.h>
+#include "ptcore/char_parsers.h"
+
+#include <string>
+#include <string_view>
+
+TEST_CASE("scan_while and scan_until")
+{
+    using ptcore::char_class;
+    using ptcore::scan_until;
+    using ptcore::scan_while;
+    namespace cc = ptcore::char_classes;
+
+    static_assert(scan_while(cc::digit, "123abc") == 3);
+    static_assert(scan_until(cc::digit, "abc123") == 3);
+    static_assert(scan_while(cc::space, "") == 0);
+
+    // long enough to exercise the 16 and 32 byte paths, with the
+    // boundary falling in every position of a block
+    for (std::size_t n = 0; n < 100; ++n)
+    {
+        CAPTURE(n);
+
+        std::string text(n, '7');
+        text += "x\xe9" "0123";
+
+        REQUIRE(scan_while(cc::digit, text) == n);
+        REQUIRE(scan_until(~cc::digit, text) == n);
+        REQUIRE(scan_until(cc::alpha, text) == n);
+
+        const char_class high = char_class::range('\x80', '\xff');
+        REQUIRE(scan_until(high, text) == n + 1);
+    }
+}
+
+TEST_CASE("char_parsers")
+{
+    using namespace std::string_view_literals;
+    namespace cc = ptcore::char_classes;
+
+    SUBCASE("match_char")
+    {
+        constexpr auto p = ptcore::match_char(cc::digit);
+
+        static_assert(p("1a")->value == '1');
+        static_assert(p("1a")->remaining_input == "a"sv);
+        static_assert(!p("a1"));
+        static_assert(!p(""));
+    }
+
+    SUBCASE("match_run")
+    {
+        constexpr auto p = ptcore::match_run(cc::identifier);
+
+        static_assert(p("foo_1 = 2")->value == "foo_1"sv);
+        static_assert(p("foo_1 = 2")->remaining_input == " = 2"sv);
+        static_assert(!p(" foo"));
+        static_assert(!p(""));
+
+        const std::string text(40, 'a');
+        const std::string input = text + "!";
+        const auto r = p(input);
+        REQUIRE(r.has_value());
+        REQUIRE(r->value == text);
+        REQUIRE(r->remaining_input == "!"sv);
+    }
+
+    SUBCASE("skip_while")
+    {
+        constexpr auto p = ptcore::skip_while(cc::space);
+
+        static_assert(p(" \t x")->value == " \t "sv);
+        static_assert(p(" \t x")->remaining_input == "x"sv);
+        static_assert(p("x")->value.empty());
+        static_assert(p("")->input_done());
+    }
+
+    SUBCASE("take_until")
+    {
+        constexpr auto p = ptcore::take_until(ptcore::char_class{ ",;" });
+
+        static_assert(p("abc,def")->value == "abc"sv);
+        static_assert(p("abc,def")->remaining_input == ",def"sv);
+        static_assert(p("abc")->value == "abc"sv);
+        static_assert(p("abc")->input_done());
+        static_assert(p(";")->value.empty());
+    }
+}
@@ -0,0 +1,104 @@
+#include <doctest/doctest.h>
+#include "ptcore/columnar.h"
+#include "ptcore/char_parsers.h"
+#include "ptcore/numeric.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+TEST_CASE("parse_records")
+{
+    using namespace std::string_view_literals;
+
+    const auto schema = ptcore::make_record_schema(
+        ptcore::match_char(','),
+        ptcore::match_integer<int>(),
+        ptcore::take_until(ptcore::char_class{ ",\r\n" }),
+        ptcore::match_floating_point<double>());
+
+    SUBCASE("columns")
+    {
+        const auto columns =
+            ptcore::parse_records(schema, "1,a,0.5\n-2,bc,1e3\r\n3,,2");
+
+        REQUIRE(columns.rows() == 3);
+        CHECK(columns.error_count() == 0);
+        CHECK(std::vector(columns.column<0>().begin(),
+                          columns.column<0>().end()) ==
+              std::vector{ 1, -2, 3 });
+        CHECK(columns.column<1>()[0] == "a"sv);
+        CHECK(columns.column<1>()[1] == "bc"sv);
+        CHECK(columns.column<1>()[2] == ""sv);
+        CHECK(columns.column<2>()[1] == 1000.0);
+        CHECK(columns.column<2>()[2] == 2.0);
+    }
+
+    SUBCASE("errors")
+    {
+        const auto columns = ptcore::parse_records(
+            schema, "1,a,0.5\nx,b,1\n2,c\n3,d,1,\n\n4,e,4\n");
+
+        REQUIRE(columns.rows() == 6);
+        CHECK(columns.error_count() == 4);
+        CHECK(!columns.failed(0));
+        CHECK(columns.failed(1));
+        CHECK(columns.failed(2));
+        CHECK(columns.failed(3));
+        CHECK(columns.failed(4));
+        CHECK(!columns.failed(5));
+        CHECK(columns.error_bitmap().size() == 1);
+        CHECK(columns.error_bitmap()[0] == 0b011110);
+        CHECK(columns.column<0>()[5] == 4);
+        CHECK(columns.column<1>()[5] == "e"sv);
+    }
+
+    SUBCASE("arena")
+    {
+        std::string input;
+        for (int i = 0; i < 1000; ++i)
+        {
+            input += std::to_string(i);
+            input += i % 7 == 0 ? ",x,?\n" : ",x,1.5\n";
+        }
+
+        std::pmr::monotonic_buffer_resource arena;
+        auto columns = ptcore::parse_records(schema, input, &arena);
+
+        REQUIRE(columns.rows() == 1000);
+        CHECK(columns.error_count() == 143);
+        CHECK(columns.error_bitmap().size() == 16);
+        for (std::size_t i = 0; i < 1000; ++i)
+        {
+            CHECK(columns.failed(i) == (i % 7 == 0));
+            if (!columns.failed(i))
+            {
+                CHECK(columns.column<0>()[i] == static_cast<int>(i));
+            }
+        }
+
+        // appending continues the same rows
+        CHECK(ptcore::parse_records(schema, "1000,y,2\n", columns) == 0);
+        CHECK(columns.rows() == 1001);
+        CHECK(columns.column<1>().back() == "y"sv);
+    }
+
+    SUBCASE("null resource")
+    {
+        std::array<std::byte, 4096> buffer;
+        std::pmr::monotonic_buffer_resource arena{
+            buffer.data(), buffer.size(), std::pmr::null_memory_resource() };
+
+        const auto ints = ptcore::make_record_schema(
+            ptcore::match_char(','), ptcore::match_integer<int>());
+
+        ptcore::record_columns<int> columns{ &arena };
+        columns.reserve(4);
+        CHECK(ptcore::parse_records(ints, "1\n2\n3\n4", columns) == 0);
+        CHECK(columns.rows() == 4);
+    }
+}
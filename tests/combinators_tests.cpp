@@ -0,0 +1,172 @@
+#include <doctest/doctest.h>
+#include "ptcore/combinators.h"
+#include "ptcore/char_parsers.h"
+#include "ptcore/numeric.h"
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <tuple>
+#include <variant>
+
+namespace
+{
+    // A parser for a fixed word that counts how often it runs.
+    struct counting_word
+    {
+        constexpr ptcore::parse_return_t<std::string_view> operator()(
+            ptcore::parse_input_t s) const
+        {
+            ++*calls;
+            if (s.starts_with(word))
+            {
+                return ptcore::parse_results{ word, s.substr(word.size()) };
+            }
+
+            return std::nullopt;
+        }
+
+        constexpr ptcore::parser_info info() const
+        {
+            return { ptcore::char_class{ word.substr(0, 1) }, word.size(),
+                     word.size() };
+        }
+
+        std::string_view word;
+        int* calls;
+    };
+}
+
+TEST_CASE("seq")
+{
+    using namespace std::string_view_literals;
+    using ptcore::match_char;
+    using ptcore::match_integer;
+    using ptcore::seq;
+
+    constexpr auto p =
+        seq(match_integer<int>(), match_char('='), match_integer<int>());
+
+    static_assert(p("1=-2;")->value == std::tuple{ 1, '=', -2 });
+    static_assert(p("1=-2;")->remaining_input == ";"sv);
+    static_assert(!p("1=x"));
+    static_assert(!p("1="));
+    static_assert(ptcore::recognize(p, "10=20x") == "x"sv);
+    static_assert(!ptcore::recognize(p, "10+20"));
+
+    constexpr auto info = p.info();
+    static_assert(info.first == (ptcore::char_classes::digit |
+                                 ptcore::char_class{ "-" }));
+    static_assert(info.min_length == 3);
+    static_assert(info.max_length == ptcore::parser_info::unbounded);
+
+    SUBCASE("nullable prefix")
+    {
+        constexpr auto q = seq(ptcore::skip_while(ptcore::char_classes::space),
+                               match_char('x'));
+
+        static_assert(q.info().first == (ptcore::char_classes::space |
+                                         ptcore::char_class{ "x" }));
+        static_assert(q("  x")->remaining_input == ""sv);
+        static_assert(q("x")->remaining_input == ""sv);
+    }
+
+    SUBCASE("incomplete")
+    {
+        // a part that matched up to the end might match more
+        static_assert(ptcore::incomplete(p, "12"));
+        static_assert(ptcore::incomplete(p, "12=-"));
+        static_assert(!ptcore::incomplete(p, "12+3"));
+        static_assert(!ptcore::incomplete(p, "1=x"));
+    }
+}
+
+TEST_CASE("alt")
+{
+    using namespace std::string_view_literals;
+    using ptcore::alt;
+    using ptcore::match_char;
+    namespace cc = ptcore::char_classes;
+
+    SUBCASE("values")
+    {
+        constexpr auto same = alt(match_char('a'), match_char(cc::digit));
+        static_assert(std::is_same_v<ptcore::parser_parse_type<decltype(same)>,
+                                     char>);
+        static_assert(same("a1")->value == 'a');
+        static_assert(same("1a")->value == '1');
+        static_assert(!same("b"));
+        static_assert(!same(""));
+
+        constexpr auto mixed =
+            alt(ptcore::match_integer<std::uint8_t>(), match_char('-'));
+        using value_t = std::variant<std::uint8_t, char>;
+        static_assert(mixed("42")->value == value_t{ std::in_place_index<0>,
+                                                     std::uint8_t{ 42 } });
+        static_assert(mixed("-1")->value == value_t{ std::in_place_index<1>,
+                                                     '-' });
+        static_assert(ptcore::recognize(mixed, "-1") == "1"sv);
+    }
+
+    SUBCASE("first match wins")
+    {
+        constexpr auto p =
+            alt(ptcore::match_run(cc::alpha), ptcore::match_run(cc::alnum));
+        static_assert(p("ab1")->value == "ab"sv);
+        static_assert(p("1ab")->value == "1ab"sv);
+    }
+
+    SUBCASE("only viable branches run")
+    {
+        int if_calls = 0;
+        int in_calls = 0;
+        int else_calls = 0;
+        int while_calls = 0;
+
+        const auto p = alt(counting_word{ "if", &if_calls },
+                           counting_word{ "in", &in_calls },
+                           counting_word{ "else", &else_calls },
+                           counting_word{ "while", &while_calls });
+
+        REQUIRE(p("else x")->value == "else"sv);
+        REQUIRE(p("in x")->value == "in"sv);
+        REQUIRE(!p("for"));
+        REQUIRE(!p("whil"));
+        REQUIRE(ptcore::recognize(p, "while") == ""sv);
+
+        REQUIRE(if_calls == 1);
+        REQUIRE(in_calls == 1);
+        REQUIRE(else_calls == 1);
+        REQUIRE(while_calls == 1);
+
+        const auto info = p.info();
+        REQUIRE(info.first == ptcore::char_class{ "iew" });
+        REQUIRE(info.min_length == 2);
+        REQUIRE(info.max_length == 5);
+    }
+
+    SUBCASE("nullable branches are always viable")
+    {
+        constexpr auto p = alt(ptcore::match_run(ptcore::char_class{ "x" }),
+                               ptcore::skip_while(cc::digit));
+        static_assert(p("x")->value == "x"sv);
+        static_assert(p("12")->value == "12"sv);
+        static_assert(p("")->value == ""sv);
+        static_assert(p("y")->remaining_input == "y"sv);
+    }
+}
+
+TEST_CASE("match_n rejects short input")
+{
+    int calls = 0;
+    const auto p = ptcore::match_n<3>(counting_word{ "ab", &calls },
+                                      ptcore::match_char(','));
+
+    REQUIRE(p.info().min_length == 8);
+    REQUIRE(!p("ab,ab,a"));
+    REQUIRE(!ptcore::recognize(p, "ab,ab"));
+    REQUIRE(calls == 0);
+
+    REQUIRE(p("ab,ab,ab").has_value());
+    REQUIRE(calls == 3);
+}
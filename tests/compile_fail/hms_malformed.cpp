@@ -0,0 +1,5 @@
+#include "ptcore/literals.h"
+
+using namespace ptcore::literals;
+
+constexpr auto t = "12:30"_hms;
@@ -0,0 +1,5 @@
+#include "ptcore/literals.h"
+
+using namespace ptcore::literals;
+
+constexpr auto t = "12:60:00"_hms;
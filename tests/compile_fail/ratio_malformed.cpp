@@ -0,0 +1,5 @@
+#include "ptcore/literals.h"
+
+using namespace ptcore::literals;
+
+using r = decltype("3/x"_ratio);
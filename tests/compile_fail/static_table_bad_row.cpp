@@ -0,0 +1,8 @@
+#include "ptcore/static_table.h"
+#include "ptcore/numeric.h"
+
+#include <string_view>
+
+constexpr auto rows = ptcore::parse_static_rows<[] {
+    return std::string_view{ "1\n2\nthree\n4" };
+}>(ptcore::match_integer<int>());
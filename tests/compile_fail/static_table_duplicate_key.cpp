@@ -0,0 +1,11 @@
+#include "ptcore/static_table.h"
+#include "ptcore/char_parsers.h"
+#include "ptcore/numeric.h"
+
+#include <string_view>
+
+constexpr auto map = ptcore::parse_static_map<[] {
+    return std::string_view{ "a=1\nb=2\na=3" };
+}>(ptcore::match_run(ptcore::char_classes::alpha),
+   ptcore::match_char('='),
+   ptcore::match_integer<int>());
@@ -0,0 +1,9 @@
+#include "ptcore/static_table.h"
+#include "ptcore/numeric.h"
+
+#include <string_view>
+
+constexpr auto rows =
+    ptcore::parse_static_rows<[] { return std::string_view{ "1\n2\n3" }; },
+                              ptcore::static_table_limits{ .max_rows = 2 }>(
+        ptcore::match_integer<int>());
@@ -0,0 +1,111 @@
+#include <doctest/doctest.h>
+#include "ptcore/file_input.h"
+#include "ptcore/char_parsers.h"
+#include "ptcore/numeric.h"
+#include "ptcore/repetition.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#if PTCORE_HAS_MMAP
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // A file in the temporary directory that is removed again.
+    struct temp_file
+    {
+        explicit temp_file(std::string const& contents)
+            : path{ std::filesystem::temp_directory_path() /
+                    ("ptcore_file_input_" + std::to_string(
+                        reinterpret_cast<std::uintptr_t>(this))) }
+        {
+            std::ofstream{ path, std::ios::binary } << contents;
+        }
+
+        ~temp_file() { std::filesystem::remove(path); }
+
+        std::filesystem::path path;
+    };
+}
+
+TEST_CASE("mapped_file")
+{
+    using namespace std::string_view_literals;
+
+    std::string text;
+    for (int i = 0; i < 100000; ++i)
+    {
+        text += std::to_string(i) + ",";
+    }
+    text += "100000";
+
+    const temp_file file{ text };
+
+    SUBCASE("contents")
+    {
+        ptcore::mapped_file f{ file.path, { .huge_pages = true } };
+#if PTCORE_HAS_MMAP
+        REQUIRE(f.is_mapped());
+#endif
+        REQUIRE(f.contents() == text);
+
+        // moving keeps the contents where they are
+        const auto data = f.contents().data();
+        const ptcore::mapped_file moved{ std::move(f) };
+        REQUIRE(moved.contents().data() == data);
+        REQUIRE(f.contents().empty());
+    }
+
+    SUBCASE("parse_file")
+    {
+        std::pmr::monotonic_buffer_resource arena;
+        const auto r = ptcore::parse_file(
+            file.path,
+            ptcore::match_entirety(ptcore::sep_by(ptcore::match_integer<int>(),
+                                                  ptcore::match_char(','),
+                                                  &arena)));
+
+        REQUIRE(r.result.has_value());
+        REQUIRE(r.result->value.size() == 100001);
+        REQUIRE(r.result->value.back() == 100000);
+    }
+
+    SUBCASE("empty file")
+    {
+        const temp_file empty{ "" };
+        const ptcore::mapped_file f{ empty.path };
+        REQUIRE(f.contents().empty());
+    }
+
+    SUBCASE("missing file")
+    {
+        REQUIRE_THROWS_AS(ptcore::mapped_file{ file.path / "missing" },
+                          std::system_error);
+    }
+
+#if PTCORE_HAS_MMAP
+    SUBCASE("pipes are read")
+    {
+        int fds[2];
+        REQUIRE(::pipe(fds) == 0);
+
+        const auto message = "1,2,3"sv;
+        REQUIRE(::write(fds[1], message.data(), message.size()) ==
+                static_cast<ssize_t>(message.size()));
+        ::close(fds[1]);
+
+        const ptcore::mapped_file f{ fds[0] };
+        ::close(fds[0]);
+
+        REQUIRE(!f.is_mapped());
+        REQUIRE(f.contents() == message);
+    }
+#endif
+}
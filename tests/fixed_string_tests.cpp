@@ -0,0 +1,30 @@
+#include <doctest/doctest.h>
+#include "ptcore/fixed_string.h"
+
+#include <string_view>
+
+namespace
+{
+    template <ptcore::fixed_string S>
+    constexpr std::string_view text_of()
+    {
+        return S.view();
+    }
+}
+
+TEST_CASE("fixed_string")
+{
+    using namespace std::string_view_literals;
+
+    constexpr ptcore::fixed_string s{ "abc" };
+
+    static_assert(s.size() == 3);
+    static_assert(s.view() == "abc"sv);
+    static_assert(s[1] == 'b');
+    static_assert(s.data()[3] == '\0');
+    static_assert(s == ptcore::fixed_string{ "abc" });
+    static_assert(s != ptcore::fixed_string{ "abcd" });
+
+    static_assert(ptcore::fixed_string{ "" }.size() == 0);
+    static_assert(text_of<"->">() == "->"sv);
+}
@@ -0,0 +1,42 @@
+#include <doctest/doctest.h>
+#include "ptcore/inline_vector.h"
+
+#include <string>
+
+TEST_CASE("inline_vector")
+{
+    using ptcore::inline_vector;
+
+    SUBCASE("constexpr")
+    {
+        static_assert(inline_vector<int, 4>::capacity() == 4);
+        static_assert(inline_vector<int, 4>{}.empty());
+        static_assert(inline_vector<int, 4>{ 1, 2 }.size() == 2);
+        static_assert(inline_vector<int, 2>{ 1, 2 }.full());
+        static_assert(inline_vector<int, 4>{ 1, 2 }.back() == 2);
+        static_assert(inline_vector<int, 4>{ 1, 2 } ==
+                      inline_vector<int, 4>{ 1, 2 });
+        static_assert(inline_vector<int, 4>{ 1, 2 } !=
+                      inline_vector<int, 4>{ 1, 2, 3 });
+        static_assert(inline_vector<int, 4>{ 1, 2 } !=
+                      inline_vector<int, 4>{ 1, 3 });
+    }
+
+    SUBCASE("modifiers")
+    {
+        inline_vector<std::string, 3> v;
+        v.push_back("a");
+        v.push_back("b");
+        REQUIRE(v.size() == 2);
+        REQUIRE(v[1] == "b");
+        REQUIRE(v.front() == "a");
+
+        v.pop_back();
+        REQUIRE(v.size() == 1);
+        REQUIRE(v.back() == "a");
+
+        v.clear();
+        REQUIRE(v.empty());
+        REQUIRE(v.begin() == v.end());
+    }
+}
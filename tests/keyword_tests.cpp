@@ -0,0 +1,178 @@
+#include <doctest/doctest.h>
+#include "ptcore/keyword.h"
+#include "ptcore/char_class.h"
+#include "ptcore/combinators.h"
+#include "ptcore/numeric.h"
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <tuple>
+
+namespace
+{
+    enum class unit
+    {
+        metre,
+        kilometre,
+        second,
+        minute,
+        inch,
+        in
+    };
+
+    constexpr auto units = ptcore::make_keywords<unit>({
+        { "m", unit::metre },
+        { "kilometre", unit::kilometre },
+        { "s", unit::second },
+        { "min", unit::minute },
+        { "inch", unit::inch },
+        { "in", unit::in },
+    });
+
+    constexpr std::size_t many = 500;
+
+    // "kw_a" to "kw_z", then "kw_aa" and so on
+    constexpr auto many_names = []
+    {
+        std::array<std::array<char, 8>, many> ret{};
+        for (std::size_t i = 0; i < many; ++i)
+        {
+            auto& name = ret[i];
+            name[0] = 'k';
+            name[1] = 'w';
+            name[2] = '_';
+
+            std::size_t n = 3;
+            for (auto v = i + 1; v > 0; v = (v - 1) / 26)
+            {
+                name[n++] = static_cast<char>('a' + (v - 1) % 26);
+            }
+        }
+        return ret;
+    }();
+
+    constexpr auto many_keywords = ptcore::make_keywords(
+        []
+        {
+            std::array<ptcore::keyword_entry<std::size_t>, many> ret{};
+            for (std::size_t i = 0; i < many; ++i)
+            {
+                ret[i] = { std::string_view{ many_names[i].data() }, i };
+            }
+            return ret;
+        }());
+}
+
+TEST_CASE("keyword_table")
+{
+    static_assert(units.size() == 6);
+    static_assert(units.find("kilometre") == unit::kilometre);
+    static_assert(units.find("in") == unit::in);
+    static_assert(units.find("inch") == unit::inch);
+    static_assert(!units.find("i"));
+    static_assert(!units.find("inches"));
+    static_assert(!units.find(""));
+
+    static_assert(units.info().first == ptcore::char_class{ "mksi" });
+    static_assert(units.info().min_length == 1);
+    static_assert(units.info().max_length == 9);
+
+    for (auto const& e : units)
+    {
+        CHECK(units.find(e.text) == e.value);
+    }
+
+    SUBCASE("hundreds of keywords")
+    {
+        static_assert(many_keywords.find("kw_a") == 0);
+        static_assert(many_keywords.find("kw_fs") == many - 1);
+
+        for (std::size_t i = 0; i < many; ++i)
+        {
+            std::string name{ many_names[i].data() };
+            REQUIRE(many_keywords.find(name) == i);
+
+            name.back() = '_';
+            CHECK(!many_keywords.find(name));
+        }
+    }
+}
+
+TEST_CASE("match_keyword")
+{
+    using namespace std::string_view_literals;
+
+    constexpr auto p = ptcore::match_keyword(units);
+
+    static_assert(p("min 5")->value == unit::minute);
+    static_assert(p("min 5")->remaining_input == " 5"sv);
+    static_assert(p("in")->value == unit::in);
+    static_assert(p("inch")->value == unit::inch);
+    static_assert(p("kilometre/s")->remaining_input == "/s"sv);
+
+    // the whole token must be a keyword
+    static_assert(!p("ins"));
+    static_assert(!p("mm"));
+    static_assert(!p(""));
+    static_assert(!p(" m"));
+
+    static_assert(ptcore::recognize(p, "s/2") == "/2"sv);
+    static_assert(!ptcore::recognize(p, "sm"));
+    static_assert(!ptcore::recognize(p, "s2"));
+
+    SUBCASE("token class")
+    {
+        constexpr auto q =
+            ptcore::match_keyword(units, ptcore::char_classes::alpha);
+
+        static_assert(q("m2")->remaining_input == "2"sv);
+        static_assert(!q("metre"));
+
+        // characters outside the class end the token
+        constexpr auto letters = ptcore::match_keyword(
+            units, ptcore::char_class::range('a', 'h'));
+        static_assert(!letters("min"));
+    }
+
+    SUBCASE("identifier tokens")
+    {
+        static constexpr auto keywords = ptcore::make_keywords<int>({
+            { "in", 0 },
+            { "if", 1 },
+        });
+        constexpr auto q = ptcore::match_keyword(keywords);
+
+        static_assert(q("in x")->value == 0);
+        static_assert(!q("int x"));
+        static_assert(!q("if_x"));
+    }
+
+    SUBCASE("parse_into")
+    {
+        unit out{};
+        ptcore::parse_cursor c{ "inch," };
+        CHECK(ptcore::parse_into(p, c, out));
+        CHECK(out == unit::inch);
+        CHECK(c.rest() == ","sv);
+
+        CHECK(!ptcore::parse_into(p, c, out));
+        CHECK(c.rest() == ","sv);
+    }
+
+    SUBCASE("in a sequence")
+    {
+        constexpr auto q = ptcore::seq(ptcore::match_integer<int>(), p);
+
+        static_assert(q("10kilometre")->value ==
+                      std::tuple{ 10, unit::kilometre });
+        static_assert(!q("10k"));
+    }
+
+    SUBCASE("long tokens")
+    {
+        const std::string text(1000, 'm');
+        CHECK(!p(text));
+    }
+}
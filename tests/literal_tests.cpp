@@ -0,0 +1,127 @@
+#include <doctest/doctest.h>
+#include "ptcore/literal.h"
+#include "ptcore/numeric.h"
+#include "ptcore/repetition.h"
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace
+{
+    constexpr char alphabet[] =
+        "abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+    template <std::size_t N>
+    constexpr ptcore::fixed_string<N> prefix()
+    {
+        char text[N + 1]{};
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            text[i] = alphabet[i];
+        }
+
+        return ptcore::fixed_string<N>{ text };
+    }
+
+    // Checks lit<S> against every input that differs from S in one byte,
+    // and against inputs that are too short.
+    template <std::size_t N>
+    void check_literal()
+    {
+        CAPTURE(N);
+
+        constexpr auto p = ptcore::lit<prefix<N>()>;
+        const std::string text{ alphabet, N };
+
+        auto input = text + "!";
+        auto r = p(input);
+        REQUIRE(r);
+        CHECK(r->value == text);
+        CHECK(r->remaining_input == "!");
+
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            input[i] ^= 0x20;
+            CHECK(!p(input));
+            input[i] ^= 0x20;
+        }
+
+        if constexpr (N > 0)
+        {
+            CHECK(!p(std::string_view{ input }.substr(0, N - 1)));
+        }
+    }
+}
+
+TEST_CASE("lit")
+{
+    using namespace std::string_view_literals;
+    using ptcore::lit;
+
+    static_assert(lit<"->">("->x")->value == "->"sv);
+    static_assert(lit<"->">("->x")->remaining_input == "x"sv);
+    static_assert(!lit<"->">("-x"));
+    static_assert(!lit<"->">("-"));
+    static_assert(lit<"">("x")->remaining_input == "x"sv);
+    static_assert(ptcore::recognize(lit<"::=">, "::=a") == "a"sv);
+    static_assert(!ptcore::recognize(lit<"::=">, "::a"));
+
+    constexpr auto info = ptcore::info(lit<"::=">);
+    static_assert(info.first == ptcore::char_class{ ":" });
+    static_assert(info.min_length == 3);
+    static_assert(info.max_length == 3);
+
+    // one character literals can take the match_char paths
+    static_assert(lit<",">.literal() == ',');
+
+    SUBCASE("every length")
+    {
+        [&]<std::size_t... N>(std::index_sequence<N...>)
+        {
+            (check_literal<N>(), ...);
+        }(std::make_index_sequence<sizeof(alphabet)>{});
+    }
+
+    SUBCASE("parse_into")
+    {
+        std::string_view out;
+        ptcore::parse_cursor c{ "<=>x" };
+        CHECK(ptcore::parse_into(lit<"<=>">, c, out));
+        CHECK(out == "<=>"sv);
+        CHECK(c.rest() == "x"sv);
+        CHECK(!ptcore::parse_into(lit<"<=>">, c, out));
+        CHECK(c.rest() == "x"sv);
+    }
+}
+
+TEST_CASE("lit as a separator")
+{
+    using namespace std::string_view_literals;
+    using ptcore::lit;
+    using ptcore::match_integer;
+
+    constexpr auto p = ptcore::match_n<3>(match_integer<int>(), lit<", ">);
+
+    static_assert(p("1, 2, 3")->value == std::array{ 1, 2, 3 });
+    static_assert(!p("1, 2,3"));
+    CHECK(p("10, -20, 30;")->value == std::array{ 10, -20, 30 });
+    CHECK(p("10, -20, 30;")->remaining_input == ";"sv);
+
+    const auto count =
+        ptcore::match_n_count(match_integer<int>(), lit<" -> ">, "1 -> 2 -> 3");
+    CHECK(count.count == 3);
+    CHECK(count.full_match);
+
+    // a one character literal takes the SIMD digit tuple path
+    constexpr auto q =
+        ptcore::match_n<4>(match_integer<unsigned>(), lit<".">);
+    CHECK(q("192.168.0.1")->value == std::array{ 192u, 168u, 0u, 1u });
+    CHECK(!q("192.168.0"));
+
+    constexpr auto r = ptcore::sep_by<4>(match_integer<int>(), lit<"||">);
+    static_assert(r("1||2||3|")->value.size() == 3);
+    static_assert(r("1||2||3|")->remaining_input == "|"sv);
+}
@@ -0,0 +1,46 @@
+#include <doctest/doctest.h>
+#include "ptcore/literals.h"
+#include "ptcore/ratio.h"
+
+#include <array>
+#include <cstdint>
+#include <ratio>
+#include <type_traits>
+
+TEST_CASE("literals")
+{
+    using namespace ptcore::literals;
+
+    SUBCASE("_ratio")
+    {
+        static_assert(std::is_same_v<decltype("3/4"_ratio), std::ratio<3, 4>>);
+        static_assert(std::is_same_v<decltype("6/8"_ratio), std::ratio<3, 4>>);
+        static_assert(
+            std::is_same_v<decltype("-10/4"_ratio), std::ratio<-5, 2>>);
+        static_assert(std::is_same_v<decltype("1000"_ratio), std::kilo>);
+        static_assert(
+            std::is_same_v<decltype("1/1000000000"_ratio), std::nano>);
+        static_assert(ptcore::ratio<decltype("0/7"_ratio)>);
+        static_assert("0/7"_ratio.den == 1);
+
+        // terms at the limits of std::intmax_t, reduced in the double
+        // width integer the compiler may not have natively
+        static_assert(
+            std::is_same_v<decltype("-9223372036854775808/4096"_ratio),
+                           std::ratio<-(std::intmax_t{1} << 51)>>);
+        static_assert(std::is_same_v<
+                      decltype("9223372036854775807/9223372036854775807"_ratio),
+                      std::ratio<1>>);
+    }
+
+    SUBCASE("_hms")
+    {
+        static_assert("12:30:05"_hms == std::array{ 12, 30, 5 });
+        static_assert("0:0:0"_hms == std::array{ 0, 0, 0 });
+        static_assert("23:59:59"_hms == std::array{ 23, 59, 59 });
+
+        // a consteval result is a constant wherever it is used
+        constexpr auto noon = "12:00:00"_hms;
+        static_assert(noon[0] * 3600 + noon[1] * 60 + noon[2] == 43200);
+    }
+}
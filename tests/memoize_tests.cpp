@@ -0,0 +1,127 @@
+#include <doctest/doctest.h>
+#include "ptcore/memoize.h"
+#include "ptcore/char_parsers.h"
+#include "ptcore/combinators.h"
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace
+{
+    struct counting_run
+    {
+        ptcore::parse_return_t<std::string_view> operator()(
+            ptcore::parse_input_t s) const
+        {
+            ++*calls;
+            return ptcore::match_run(ptcore::char_classes::digit)(s);
+        }
+
+        int* calls;
+    };
+
+    using rule_t =
+        std::function<ptcore::parse_return_t<int>(ptcore::parse_input_t)>;
+
+    // nested := '(' nested ')' 'a' | '(' nested ')' 'b' | 'c'
+    //
+    // Without memoization, a failed first branch reparses the whole inner
+    // text, which is exponential in the nesting depth.
+    struct nested
+    {
+        ptcore::parse_return_t<int> operator()(ptcore::parse_input_t s) const
+        {
+            ++*calls;
+
+            if (s.starts_with('c'))
+            {
+                return ptcore::parse_results{ 0, s.substr(1) };
+            }
+
+            if (!s.starts_with('('))
+            {
+                return std::nullopt;
+            }
+
+            for (const auto tail : { ")a", ")b" })
+            {
+                const auto r = (*rule)(s.substr(1));
+                if (r && r->remaining_input.starts_with(tail))
+                {
+                    return ptcore::parse_results{
+                        r->value + 1, r->remaining_input.substr(2) };
+                }
+            }
+
+            return std::nullopt;
+        }
+
+        rule_t const* rule;
+        int* calls;
+    };
+}
+
+TEST_CASE("memoize")
+{
+    using namespace std::string_view_literals;
+
+    ptcore::memo_arena arena;
+
+    SUBCASE("backtracking alternatives")
+    {
+        int calls = 0;
+        const auto word = ptcore::memoize(counting_run{ &calls }, arena);
+        const auto p = ptcore::alt(ptcore::seq(word, ptcore::match_char('x')),
+                                   ptcore::seq(word, ptcore::match_char('y')));
+
+        const auto text = "123y"sv;
+        arena.reset(text);
+
+        const auto r = p(text);
+        REQUIRE(r.has_value());
+        REQUIRE(std::get<0>(r->value) == "123"sv);
+        REQUIRE(calls == 1);
+
+        // failures are memoized as well
+        REQUIRE(!p(text.substr(3)));
+        REQUIRE(!p(text.substr(3)));
+        REQUIRE(calls == 2);
+
+        // a new parse starts with an empty table
+        arena.reset(text);
+        REQUIRE(p(text).has_value());
+        REQUIRE(calls == 3);
+
+        // input that is not a suffix of the arena's input is not memoized
+        const std::string other{ text };
+        REQUIRE(p(other).has_value());
+        REQUIRE(p(other).has_value());
+        REQUIRE(calls == 7);
+    }
+
+    SUBCASE("linear in the nesting depth")
+    {
+        constexpr int depth = 24;
+
+        std::string text(depth, '(');
+        text += 'c';
+        for (int i = 0; i < depth; ++i)
+        {
+            text += ")b";
+        }
+
+        int calls = 0;
+        rule_t rule;
+        const auto p = ptcore::memoize(nested{ &rule, &calls }, arena);
+        rule = std::cref(p);
+
+        arena.reset(text);
+        const auto r = p(text);
+        REQUIRE(r.has_value());
+        REQUIRE(r->value == depth);
+        REQUIRE(r->input_done());
+        REQUIRE(calls == depth + 1);
+    }
+}
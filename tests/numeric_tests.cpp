@@ -0,0 +1,209 @@
+#include <doctest/doctest.h>
+#include "ptcore/numeric.h"
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <tuple>
+
+TEST_CASE("match_integer")
+{
+    using namespace std::string_view_literals;
+    using ptcore::match_integer;
+
+    SUBCASE("constexpr")
+    {
+        constexpr auto p = match_integer<int>();
+
+        static_assert(p("123abc")->value == 123);
+        static_assert(p("123abc")->remaining_input == "abc"sv);
+        static_assert(p("-42")->value == -42);
+        static_assert(p("0012345678")->value == 12345678);
+        static_assert(!p("0012345678901"));
+        static_assert(!p("-"));
+        static_assert(!p("+1"));
+        static_assert(!p("inf"));
+        static_assert(!p("nan"));
+        static_assert(!p(""));
+        static_assert(!match_integer<unsigned>()("-1"));
+    }
+
+    SUBCASE("limits")
+    {
+        std::array test_values =
+        {
+            std::tuple{ "255"sv, true },
+            std::tuple{ "256"sv, false },
+            std::tuple{ "0000000000000255"sv, true },
+            std::tuple{ "99999999999999999999999"sv, false }
+        };
+
+        for (int i = 0; auto const& [text, expected] : test_values)
+        {
+            CAPTURE(i++);
+
+            REQUIRE(match_integer<std::uint8_t>()(text).has_value() ==
+                    expected);
+        }
+
+        constexpr auto p64 = match_integer<std::int64_t>();
+        REQUIRE(p64("9223372036854775807")->value ==
+                std::numeric_limits<std::int64_t>::max());
+        REQUIRE(p64("-9223372036854775808")->value ==
+                std::numeric_limits<std::int64_t>::min());
+        REQUIRE(!p64("9223372036854775808"));
+        REQUIRE(!p64("-9223372036854775809"));
+
+        constexpr auto pu64 = match_integer<std::uint64_t>();
+        REQUIRE(pu64("18446744073709551615")->value ==
+                std::numeric_limits<std::uint64_t>::max());
+        REQUIRE(!pu64("18446744073709551616"));
+
+        REQUIRE(!match_integer<std::uint16_t>()("12345678"));
+        REQUIRE(match_integer<std::uint32_t>()("12345678")->value == 12345678);
+
+        REQUIRE(match_integer<std::int8_t>()("-128")->value == -128);
+        REQUIRE(!match_integer<std::int8_t>()("128"));
+    }
+
+    SUBCASE("matches std::from_chars")
+    {
+        constexpr auto p = match_integer<std::uint32_t>();
+
+        for (std::uint64_t v = 1; v < 100000000000; v = v * 7 + 3)
+        {
+            const auto text = std::to_string(v) + ":";
+            CAPTURE(text);
+
+            std::uint32_t expected{};
+            const auto [ptr, ec] =
+                std::from_chars(text.data(), text.data() + text.size(),
+                                expected);
+
+            const auto r = p(text);
+            REQUIRE(r.has_value() == (ec == std::errc{}));
+            if (r)
+            {
+                REQUIRE(r->value == expected);
+                REQUIRE(r->remaining_input == ":"sv);
+            }
+        }
+    }
+}
+
+TEST_CASE("match_floating_point")
+{
+    using namespace std::string_view_literals;
+    using ptcore::match_floating_point;
+
+    SUBCASE("constexpr")
+    {
+        constexpr auto p = match_floating_point<double>();
+
+        static_assert(p("1.5")->value == 1.5);
+        static_assert(p("-0.25e1x")->value == -2.5);
+        static_assert(p("-0.25e1x")->remaining_input == "x"sv);
+        static_assert(p("1e")->remaining_input == "e"sv);
+        static_assert(p(".5")->value == 0.5);
+        static_assert(p("5.")->value == 5.0);
+        static_assert(p("1e400")->value ==
+                      std::numeric_limits<double>::infinity());
+        static_assert(p("1e-400")->value == 0.0);
+        static_assert(p("2.2250738585072014e-308")->value ==
+                      std::numeric_limits<double>::min());
+        static_assert(p("4.9406564584124654e-324")->value ==
+                      std::numeric_limits<double>::denorm_min());
+        static_assert(p("0.1")->value == 0.1);
+        static_assert(p("123456789012345678901234567890")->value ==
+                      123456789012345678901234567890.0);
+        static_assert(!p("."));
+        static_assert(!p("-"));
+        static_assert(!p("e5"));
+        static_assert(!p("+1"));
+
+        static_assert(match_floating_point<float>()("3.4028235e38")->value ==
+                      std::numeric_limits<float>::max());
+        static_assert(match_floating_point<float>()("0.1")->value == 0.1f);
+    }
+
+    SUBCASE("matches std::from_chars")
+    {
+        std::array test_values =
+        {
+            "0"sv,
+            "-0"sv,
+            "3.141592653589793238462643383279"sv,
+            "1.7976931348623157e308"sv,
+            "2.4703282292062328e-324"sv,
+            "9007199254740993"sv,
+            "9007199254740992.000000000000000000001"sv,
+            "7.038531e-26"sv,
+            "0.000000000000000000000000000000000000001"sv,
+            "1234567890.1234567890e-5"sv
+        };
+
+        for (int i = 0; auto const& text : test_values)
+        {
+            CAPTURE(i++);
+
+            double expected{};
+            std::from_chars(text.data(), text.data() + text.size(), expected);
+
+            const auto r = match_floating_point<double>()(text);
+            REQUIRE(r.has_value());
+            REQUIRE(r->input_done());
+            REQUIRE(r->value == expected);
+            REQUIRE(std::signbit(r->value) == std::signbit(expected));
+
+            float expected_float{};
+            std::from_chars(text.data(), text.data() + text.size(),
+                            expected_float);
+
+            const auto rf = match_floating_point<float>()(text);
+            REQUIRE(rf.has_value());
+            if (std::isfinite(expected_float) && expected_float != 0)
+            {
+                REQUIRE(rf->value == expected_float);
+            }
+        }
+    }
+}
+
+TEST_CASE("numeric recognize")
+{
+    using namespace std::string_view_literals;
+    using ptcore::recognize;
+
+    SUBCASE("integers")
+    {
+        constexpr auto p = ptcore::match_integer<std::int16_t>();
+
+        static_assert(recognize(p, "-32768x") == "x"sv);
+        static_assert(!recognize(p, "-32769"));
+        static_assert(recognize(p, "0000000000032767") == ""sv);
+        static_assert(!recognize(p, "32768"));
+        static_assert(!recognize(p, "-"));
+        static_assert(!recognize(p, "x"));
+
+        static_assert(recognize(ptcore::match_integer<std::uint64_t>(),
+                                "18446744073709551615") == ""sv);
+        static_assert(!recognize(ptcore::match_integer<std::uint64_t>(),
+                                 "18446744073709551616"));
+    }
+
+    SUBCASE("floating point")
+    {
+        constexpr auto p = ptcore::match_floating_point<double>();
+
+        // recognize skips the conversion, so even a halfway case that
+        // needs the runtime fallback is fine in constant evaluation
+        static_assert(recognize(p, "9007199254740993.0000000000000000001x") ==
+                      "x"sv);
+        static_assert(recognize(p, "1e") == "e"sv);
+        static_assert(!recognize(p, "."));
+    }
+}
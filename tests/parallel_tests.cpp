@@ -0,0 +1,106 @@
+#include <doctest/doctest.h>
+#include "ptcore/parallel.h"
+#include "ptcore/numeric.h"
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+    std::string make_list(std::size_t count)
+    {
+        std::string ret;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (i != 0)
+            {
+                ret += ',';
+            }
+            ret += std::to_string(i * 37);
+        }
+        return ret;
+    }
+}
+
+TEST_CASE("collect_separated")
+{
+    using namespace std::string_view_literals;
+
+    const auto p = ptcore::match_integer<int>();
+    const auto sep = ptcore::match_char(',');
+
+    auto r = ptcore::collect_separated(p, sep, "1,2,3"sv);
+    REQUIRE(r.values == std::vector<int>{ 1, 2, 3 });
+    REQUIRE(r.full_match);
+
+    r = ptcore::collect_separated(p, sep, "1,2,x"sv);
+    REQUIRE(r.values == std::vector<int>{ 1, 2 });
+    REQUIRE_FALSE(r.full_match);
+
+    r = ptcore::collect_separated(p, sep, ""sv);
+    REQUIRE(r.values.empty());
+    REQUIRE_FALSE(r.full_match);
+}
+
+TEST_CASE("parallel parsing")
+{
+    const auto p = ptcore::match_integer<int>();
+    const auto sep = ptcore::match_char(',');
+
+    // tiny chunks so that every input is split many times
+    const ptcore::parallel_options opts{ 4, 16 };
+
+    std::vector<std::string> inputs =
+    {
+        "",
+        "x",
+        "1",
+        "1,",
+        ",1",
+        make_list(1000)
+    };
+
+    // a failure at various points of a long list
+    for (std::size_t pos : { 0, 1, 100, 2000, 3800 })
+    {
+        auto text = make_list(1000);
+        text[pos] = 'x';
+        inputs.push_back(text);
+    }
+
+    for (int i = 0; auto const& text : inputs)
+    {
+        CAPTURE(i++);
+
+        const auto expected = ptcore::match_n_count(p, sep, text);
+        const auto result = ptcore::parallel_match_n_count(p, ',', text, opts);
+        REQUIRE(result.count == expected.count);
+        REQUIRE(result.full_match == expected.full_match);
+
+        const auto expected_list = ptcore::collect_separated(p, sep, text);
+        const auto list =
+            ptcore::parallel_collect_separated(p, ',', text, opts);
+        REQUIRE(list.values == expected_list.values);
+        REQUIRE(list.full_match == expected_list.full_match);
+    }
+
+    SUBCASE("exceptions reach the caller")
+    {
+        const auto throwing = [](ptcore::parse_input_t s)
+            -> ptcore::parse_return_t<int>
+        {
+            if (s.starts_with("13"))
+            {
+                throw std::runtime_error{ "13" };
+            }
+            return ptcore::match_integer<int>()(s);
+        };
+
+        REQUIRE_THROWS_AS(ptcore::parallel_match_n_count(
+                              throwing, ',', "1,2,13,4,5,6,7,8,9,10", opts),
+                          std::runtime_error);
+    }
+}
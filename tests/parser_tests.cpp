@@ -1,8 +1,12 @@
 #include <doctest/doctest.h>
 #include "ptcore/parser.h"
+#include "ptcore/char_parsers.h"
+#include "ptcore/numeric.h"
 
 #include <type_traits>
 #include <array>
+#include <cstdint>
+#include <stdexcept>
 #include <easy/test/type_list.h>
 #include "tests/fixtures/parse_results_fixture.h"
 
@@ -293,3 +297,357 @@ TEST_CASE("match_n")
         }
     }
 }
+
+TEST_CASE("match_n digit tuples")
+{
+    using namespace std::string_view_literals;
+    using ptcore::match_char;
+    using ptcore::match_integer;
+    using ptcore::match_n;
+
+    // match_integer<unsigned> with a single character separator takes the
+    // vectorized path at runtime; it must agree with the generic path,
+    // which is what constant evaluation always uses.
+    SUBCASE("matches the generic path")
+    {
+        using results_t = ptcore::parse_results<std::array<std::uint8_t, 3>>;
+        using expected_t = ptcore::parse_return_t<std::array<std::uint8_t, 3>>;
+
+        constexpr auto p =
+            match_n<3>(match_integer<std::uint8_t>(), match_char(':'));
+
+        constexpr std::array test_values =
+        {
+            std::tuple{ "12:30:05"sv, expected_t{results_t{{12, 30, 5}, ""sv}} },
+            std::tuple{ "12:30:05Z"sv, expected_t{results_t{{12, 30, 5}, "Z"sv}} },
+            std::tuple{ "12:30:05:"sv, expected_t{results_t{{12, 30, 5}, ":"sv}} },
+            std::tuple{ "12:30:05 and some more text"sv,
+                        expected_t{results_t{{12, 30, 5}, " and some more text"sv}} },
+            std::tuple{ "0000000000012:1:2"sv, expected_t{results_t{{12, 1, 2}, ""sv}} },
+            std::tuple{ "00000000000012:1:2"sv, expected_t{results_t{{12, 1, 2}, ""sv}} },
+            std::tuple{ "1:2:255000000000000"sv, expected_t{std::nullopt} },
+            std::tuple{ "1:2:0000000000000255"sv, expected_t{results_t{{1, 2, 255}, ""sv}} },
+            std::tuple{ "12:30:256"sv, expected_t{std::nullopt} },
+            std::tuple{ "12:30"sv, expected_t{std::nullopt} },
+            std::tuple{ "12:30:"sv, expected_t{std::nullopt} },
+            std::tuple{ "12::05"sv, expected_t{std::nullopt} },
+            std::tuple{ "12-30-05"sv, expected_t{std::nullopt} },
+            std::tuple{ ":12:30:05"sv, expected_t{std::nullopt} },
+            std::tuple{ ""sv, expected_t{std::nullopt} }
+        };
+
+        for (int i = 0; auto const& [text, expected_value] : test_values)
+        {
+            CAPTURE(i++);
+
+            REQUIRE(p(text) == expected_value);
+        }
+
+        static_assert(p("12:30:05Z") == std::get<1>(test_values[1]));
+        static_assert(p("12:30:256") == std::nullopt);
+    }
+
+    SUBCASE("dotted quad")
+    {
+        constexpr auto p =
+            match_n<4>(match_integer<std::uint8_t>(), match_char('.'));
+
+        const auto r = p("192.168.100.255/24");
+        REQUIRE(r.has_value());
+        REQUIRE(r->value == std::array<std::uint8_t, 4>{ 192, 168, 100, 255 });
+        REQUIRE(r->remaining_input == "/24"sv);
+
+        REQUIRE(p("192.168.100.256") == std::nullopt);
+        REQUIRE(p("192.168.100") == std::nullopt);
+    }
+}
+
+namespace
+{
+    // Counts how often each mode runs, to check that combinators use the
+    // recognize path of their children.
+    struct counting_digit
+    {
+        constexpr ptcore::parse_return_t<int> operator()(
+            ptcore::parse_input_t s) const
+        {
+            ++*parses;
+            return match_digit()(s);
+        }
+
+        constexpr ptcore::recognize_return_t recognize(
+            ptcore::parse_input_t s) const
+        {
+            ++*recognizes;
+            if (!s.empty() && s.front() >= '0' && s.front() <= '9')
+            {
+                return s.substr(1);
+            }
+
+            return std::nullopt;
+        }
+
+        int* parses;
+        int* recognizes;
+    };
+}
+
+TEST_CASE("recognize")
+{
+    using namespace std::string_view_literals;
+    using ptcore::recognize;
+
+    static_assert(ptcore::recognizer<counting_digit>);
+    static_assert(!ptcore::recognizer<decltype(match_digit())>);
+
+    SUBCASE("falls back to parsing")
+    {
+        static_assert(recognize(match_digit(), "1a") == "a"sv);
+        static_assert(!recognize(match_digit(), "a"));
+    }
+
+    SUBCASE("combinators propagate recognize")
+    {
+        int parses = 0;
+        int recognizes = 0;
+        const counting_digit digit{ &parses, &recognizes };
+
+        REQUIRE(recognize(ptcore::match_entirety(digit), "1") == ""sv);
+        REQUIRE(!recognize(ptcore::match_entirety(digit), "12"));
+
+        const auto p = ptcore::match_n<3>(digit, ptcore::match_char(':'));
+        REQUIRE(recognize(p, "1:2:3x") == "x"sv);
+        REQUIRE(!recognize(p, "1:2"));
+
+        REQUIRE(ptcore::match_n_count(digit, ptcore::match_char(','),
+                                      "1,2,3,4")
+                    .full_match);
+
+        REQUIRE(parses == 0);
+        REQUIRE(recognizes > 0);
+    }
+
+    SUBCASE("agrees with parsing")
+    {
+        constexpr auto p =
+            ptcore::match_n<3>(ptcore::match_integer<std::uint8_t>(),
+                       ptcore::match_char('.'));
+
+        for (const auto text : { "1.2.3"sv, "1.2.3.4"sv, "1.2"sv,
+                                 "255.0.00000000000000000001x"sv,
+                                 "255.0.256"sv, "1.2.99999999999999999999"sv })
+        {
+            CAPTURE(text);
+
+            const auto r = p(text);
+            const auto rr = recognize(p, text);
+            REQUIRE(r.has_value() == rr.has_value());
+            if (r)
+            {
+                REQUIRE(r->remaining_input == *rr);
+            }
+        }
+    }
+}
+
+namespace
+{
+    // A value that counts how often it is copied or moved.
+    struct block
+    {
+        block() = default;
+
+        block(block const& other) : id{ other.id } { ++transfers; }
+        block(block&& other) : id{ other.id } { ++transfers; }
+
+        block& operator=(block const& other)
+        {
+            id = other.id;
+            ++transfers;
+            return *this;
+        }
+
+        block& operator=(block&& other)
+        {
+            id = other.id;
+            ++transfers;
+            return *this;
+        }
+
+        int id{0};
+        std::array<char, 256> payload{};
+
+        static inline int transfers = 0;
+    };
+
+    struct block_parser
+    {
+        ptcore::parse_return_t<block> operator()(ptcore::parse_input_t s) const
+        {
+            block b;
+            if (parse_into_block(s, b))
+            {
+                return ptcore::parse_results{ std::move(b), s.substr(1) };
+            }
+
+            return std::nullopt;
+        }
+
+        bool parse_into(ptcore::parse_cursor& c, block& out) const
+        {
+            if (parse_into_block(c.rest(), out))
+            {
+                ++c.pos;
+                return true;
+            }
+
+            return false;
+        }
+
+        static bool parse_into_block(ptcore::parse_input_t s, block& out)
+        {
+            if (s.empty() || s.front() < '0' || s.front() > '9')
+            {
+                return false;
+            }
+
+            out.id = s.front() - '0';
+            return true;
+        }
+    };
+}
+
+TEST_CASE("parse_into")
+{
+    using namespace std::string_view_literals;
+    using ptcore::parse_cursor;
+
+    static_assert(ptcore::cursor_parser<block_parser>);
+    static_assert(!ptcore::cursor_parser<decltype(match_digit())>);
+
+    SUBCASE("adapts plain parsers")
+    {
+        const auto text = "7x"sv;
+        parse_cursor c{ text };
+        int out = 0;
+        REQUIRE(ptcore::parse_into(match_digit(), c, out));
+        REQUIRE(out == 7);
+        REQUIRE(c.rest() == "x"sv);
+
+        REQUIRE(!ptcore::parse_into(match_digit(), c, out));
+        REQUIRE(c.rest() == "x"sv);
+    }
+
+    SUBCASE("match_n writes in place")
+    {
+        const auto p = ptcore::match_n<4>(block_parser{},
+                                          ptcore::match_char(','));
+        const auto text = "1,2,3,4;"sv;
+
+        std::array<block, 4> out;
+        parse_cursor c{ text };
+        block::transfers = 0;
+        REQUIRE(ptcore::parse_into(p, c, out));
+        REQUIRE(block::transfers == 0);
+        REQUIRE(out[3].id == 4);
+        REQUIRE(c.rest() == ";"sv);
+
+        // a failure leaves the cursor where it was
+        parse_cursor c2{ "1,2,x,4"sv };
+        const auto start = c2.pos;
+        REQUIRE(!ptcore::parse_into(p, c2, out));
+        REQUIRE(c2.pos == start);
+
+        // the parser protocol is still there
+        const auto r = p(text);
+        REQUIRE(r.has_value());
+        REQUIRE(r->value[2].id == 3);
+        REQUIRE(r->remaining_input == ";"sv);
+    }
+
+    SUBCASE("match_entirety")
+    {
+        constexpr auto p = ptcore::match_entirety(
+            ptcore::match_n<2>(ptcore::match_integer<int>(),
+                               ptcore::match_char(':')));
+
+        std::array<int, 2> out{};
+        parse_cursor c{ "12:34"sv };
+        REQUIRE(ptcore::parse_into(p, c, out));
+        REQUIRE(out == std::array{ 12, 34 });
+        REQUIRE(c.empty());
+
+        parse_cursor c2{ "12:34:"sv };
+        REQUIRE(!ptcore::parse_into(p, c2, out));
+        REQUIRE(c2.size() == 6);
+
+        static_assert(p("12:34")->value == std::array{ 12, 34 });
+    }
+
+    SUBCASE("the remaining input must be a suffix of the input")
+    {
+        const auto copy = [](ptcore::parse_input_t s)
+            -> ptcore::parse_return_t<char>
+        {
+            static constexpr std::string_view elsewhere = "xy";
+            return ptcore::parse_results{ s.front(),
+                                          elsewhere.substr(0, s.size() - 1) };
+        };
+
+        const auto all = [](ptcore::parse_input_t s)
+            -> ptcore::parse_return_t<char>
+        {
+            return ptcore::parse_results{ s.front(), ptcore::parse_input_t{} };
+        };
+
+        char out{};
+        parse_cursor c{ "abc"sv };
+        REQUIRE_THROWS_AS(ptcore::parse_into(copy, c, out), std::logic_error);
+        REQUIRE(c.size() == 3);
+
+        REQUIRE(ptcore::parse_into(all, c, out));
+        REQUIRE(out == 'a');
+        REQUIRE(c.empty());
+    }
+}
+
+TEST_CASE("incomplete")
+{
+    using ptcore::incomplete;
+    using ptcore::match_char;
+    using ptcore::match_integer;
+
+    SUBCASE("primitives")
+    {
+        static_assert(incomplete(match_char(':'), ""));
+        static_assert(!incomplete(match_char(':'), "x"));
+        static_assert(incomplete(match_integer<int>(), "-"));
+        static_assert(!incomplete(match_integer<int>(), "-x"));
+        static_assert(!incomplete(match_integer<std::uint8_t>(), "999"));
+        static_assert(incomplete(ptcore::match_floating_point<double>(), "-."));
+        static_assert(!incomplete(ptcore::match_floating_point<double>(), "e"));
+
+        constexpr auto word = ptcore::match_run(ptcore::char_classes::alpha);
+        static_assert(incomplete(word, ""));
+        static_assert(!incomplete(word, "1"));
+    }
+
+    SUBCASE("match_n stops at the first part that cannot match")
+    {
+        constexpr auto p = ptcore::match_n<3>(match_integer<int>(),
+                                              match_char(':'));
+
+        static_assert(incomplete(p, "1:2"));
+        static_assert(incomplete(p, "1:2:"));
+        static_assert(!incomplete(p, "1:x:3"));
+        static_assert(!incomplete(p, "1;2:3"));
+        static_assert(!incomplete(ptcore::match_entirety(p), "1:2:3;"));
+    }
+
+    SUBCASE("parsers without incomplete are judged by their info")
+    {
+        static_assert(!ptcore::incremental_parser<decltype(match_digit())>);
+        static_assert(incomplete(match_digit(), ""));
+        static_assert(incomplete(match_digit(), "x"));
+    }
+}
@@ -0,0 +1,194 @@
+#include <doctest/doctest.h>
+#include "ptcore/pattern_set.h"
+#include "ptcore/combinators.h"
+#include "ptcore/char_parsers.h"
+
+#include <cstddef>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // The first match the slow way: the lowest id pattern at the first
+    // position where any pattern occurs.
+    std::optional<ptcore::pattern_match> find_slowly(
+        std::vector<std::string> const& patterns, std::string_view s)
+    {
+        for (std::size_t start = 0; start < s.size(); ++start)
+        {
+            for (std::size_t id = 0; id < patterns.size(); ++id)
+            {
+                if (s.substr(start).starts_with(patterns[id]))
+                {
+                    return ptcore::pattern_match{
+                        id, s.substr(0, start),
+                        s.substr(start, patterns[id].size()) };
+                }
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    std::string random_text(std::mt19937& rng,
+                            std::size_t length,
+                            std::string_view alphabet)
+    {
+        std::uniform_int_distribution<std::size_t> pick(0,
+                                                         alphabet.size() - 1);
+        std::string ret;
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            ret += alphabet[pick(rng)];
+        }
+        return ret;
+    }
+
+    void check_random(std::size_t pattern_count, std::size_t max_length)
+    {
+        CAPTURE(pattern_count);
+
+        std::mt19937 rng{ static_cast<unsigned>(pattern_count) };
+        std::uniform_int_distribution<std::size_t> length(1, max_length);
+
+        std::vector<std::string> patterns;
+        for (std::size_t i = 0; i < pattern_count; ++i)
+        {
+            patterns.push_back(random_text(rng, length(rng), "abcd"));
+        }
+
+        const ptcore::pattern_set set{ patterns };
+
+        for (int i = 0; i < 500; ++i)
+        {
+            const auto text = random_text(rng, i % 100, "abcde");
+            CAPTURE(text);
+
+            const auto expected = find_slowly(patterns, text);
+            const auto r = set(text);
+            REQUIRE(r.has_value() == expected.has_value());
+            if (r)
+            {
+                REQUIRE(r->value == *expected);
+                REQUIRE(r->remaining_input.data() ==
+                        expected->text.data() + expected->text.size());
+            }
+        }
+    }
+}
+
+TEST_CASE("pattern_set")
+{
+    using namespace std::string_view_literals;
+
+    const ptcore::pattern_set markers{ "<b>", "</b>", "<br/>", "<", "->" };
+
+    auto r = markers("a -> <b>x</b>");
+    REQUIRE(r);
+    CHECK(r->value.id == 4);
+    CHECK(r->value.skipped == "a "sv);
+    CHECK(r->value.text == "->"sv);
+    CHECK(r->remaining_input == " <b>x</b>"sv);
+
+    // at the same start, the first pattern in the set wins
+    r = markers(r->remaining_input);
+    REQUIRE(r);
+    CHECK(r->value.id == 0);
+    CHECK(r->remaining_input == "x</b>"sv);
+
+    r = markers("<br/>");
+    REQUIRE(r);
+    CHECK(r->value.id == 2);
+
+    CHECK(!markers("no markers here"));
+    CHECK(!markers(""));
+    CHECK(ptcore::recognize(markers, "x</b>y") == "y"sv);
+
+    CHECK(markers.size() == 5);
+    CHECK(markers.pattern(2) == "<br/>"sv);
+    CHECK(ptcore::info(markers).min_length == 1);
+
+    REQUIRE_THROWS_AS(ptcore::pattern_set({ "a", "" }),
+                      std::invalid_argument);
+
+    SUBCASE("a later match that starts earlier")
+    {
+        const ptcore::pattern_set set{ "bc", "abcd" };
+        const auto m = set("xabcd");
+        REQUIRE(m);
+        CHECK(m->value.id == 1);
+        CHECK(m->value.skipped == "x"sv);
+    }
+
+    SUBCASE("in a sequence")
+    {
+        // skip to the next tag, then read its name
+        const auto p =
+            ptcore::seq(ptcore::pattern_set{ "<", "&" },
+                        ptcore::match_run(ptcore::char_classes::alpha));
+        const auto m = p("text <tag>");
+        REQUIRE(m);
+        CHECK(std::get<1>(m->value) == "tag"sv);
+    }
+}
+
+TEST_CASE("pattern_set matches like a loop over the patterns")
+{
+    // small sets take the Teddy path where SSSE3 is available
+    check_random(1, 4);
+    check_random(5, 2);
+    check_random(8, 6);
+    check_random(32, 5);
+    check_random(20, 1);
+
+    // large sets take the automaton
+    check_random(33, 5);
+    check_random(200, 8);
+    check_random(2000, 12);
+
+    SUBCASE("long input")
+    {
+        const ptcore::pattern_set set{ "needle", "pin" };
+        std::string text(100000, 'n');
+        text += "pineedle";
+
+        const auto r = set(text);
+        REQUIRE(r);
+        CHECK(r->value.id == 1);
+        CHECK(r->value.skipped.size() == 100000);
+    }
+}
+
+TEST_CASE("pattern_set is shared across threads")
+{
+    std::vector<std::string> patterns;
+    for (int i = 0; i < 100; ++i)
+    {
+        patterns.push_back("key" + std::to_string(i) + "=");
+    }
+
+    const ptcore::pattern_set set{ patterns };
+
+    std::vector<std::jthread> threads;
+    std::vector<int> found(4, -1);
+    for (std::size_t t = 0; t < found.size(); ++t)
+    {
+        threads.emplace_back(
+            [copy = set, &found, t]
+            {
+                const auto text = "x key" + std::to_string(t * 7) + "=1";
+                if (const auto r = copy(text))
+                {
+                    found[t] = static_cast<int>(r->value.id);
+                }
+            });
+    }
+
+    threads.clear();
+    CHECK(found == std::vector{ 0, 7, 14, 21 });
+}
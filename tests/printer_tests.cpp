@@ -0,0 +1,205 @@
+#include <doctest/doctest.h>
+#include "ptcore/printer.h"
+#include "ptcore/char_parsers.h"
+#include "ptcore/combinators.h"
+#include "ptcore/numeric.h"
+#include "ptcore/repetition.h"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+    // Prints v, checking size and max_size, and that every buffer too
+    // short for the text is rejected.
+    template <typename P, typename T>
+    std::string print_checked(P const& p, T const& v)
+    {
+        std::string ret;
+        ptcore::print_append(p, ret, v);
+        REQUIRE(ret.size() <= p.max_size(v));
+        if constexpr (ptcore::sized_printer_for<P, T>)
+        {
+            REQUIRE(ret.size() == p.size(v));
+        }
+
+        std::vector<char> buffer(ret.size());
+        for (std::size_t n = 0; n < ret.size(); ++n)
+        {
+            REQUIRE(!ptcore::print_to(p, std::span{ buffer.data(), n }, v));
+        }
+
+        REQUIRE(ptcore::print_to(p, std::span{ buffer }, v) == ret.size());
+        REQUIRE(std::string_view{ buffer.data(), buffer.size() } == ret);
+        return ret;
+    }
+}
+
+TEST_CASE("decimal_digits")
+{
+    using ptcore::detail::decimal_digits;
+
+    static_assert(decimal_digits(0) == 1);
+    static_assert(decimal_digits(9) == 1);
+    static_assert(decimal_digits(10) == 2);
+    static_assert(decimal_digits(~std::uint64_t{0}) == 20);
+
+    std::uint64_t power = 1;
+    for (std::size_t digits = 1; digits < 20; ++digits)
+    {
+        CHECK(decimal_digits(power) == digits);
+        CHECK(decimal_digits(power * 10 - 1) == digits);
+        power *= 10;
+    }
+}
+
+TEST_CASE("print_integer")
+{
+    CHECK(print_checked(ptcore::print_integer<int>(), 0) == "0");
+    CHECK(print_checked(ptcore::print_integer<int>(), -42) == "-42");
+    CHECK(print_checked(ptcore::print_integer<std::int64_t>(),
+                        std::numeric_limits<std::int64_t>::min()) ==
+          "-9223372036854775808");
+    CHECK(print_checked(ptcore::print_integer<std::uint64_t>(),
+                        ~std::uint64_t{0}) == "18446744073709551615");
+
+    std::mt19937_64 rng{ 25 };
+    for (int i = 0; i < 10000; ++i)
+    {
+        const auto v = static_cast<std::int64_t>(rng() >> (rng() % 64));
+        const auto text =
+            print_checked(ptcore::print_integer<std::int64_t>(), v);
+        REQUIRE(ptcore::match_entirety(ptcore::match_integer<std::int64_t>())(
+                    text)->value == v);
+    }
+}
+
+TEST_CASE("print_floating_point")
+{
+    const auto p = ptcore::print_floating_point<double>();
+
+    CHECK(print_checked(p, 0.5) == "0.5");
+    CHECK(print_checked(p, -1e300) == "-1e+300");
+    print_checked(p, -2.2250738585072014e-308);
+    print_checked(ptcore::print_floating_point<float>(),
+                  -1.17549435e-38f);
+
+    // exponents of four digits
+    const auto q = ptcore::print_floating_point<long double>();
+    using long_limits = std::numeric_limits<long double>;
+    print_checked(q, long_limits::lowest());
+    print_checked(q, -long_limits::min());
+    print_checked(q, -long_limits::denorm_min());
+    print_checked(q, -1.18513896556122711375e-4916L);
+
+    // the text reads back as the same value
+    std::mt19937_64 rng{ 25 };
+    for (int i = 0; i < 10000; ++i)
+    {
+        const auto v = std::bit_cast<double>(rng());
+        if (v != v || v - v != 0)
+        {
+            continue;
+        }
+
+        const auto text = print_checked(p, v);
+        REQUIRE(ptcore::match_entirety(
+                    ptcore::match_floating_point<double>())(text)->value ==
+                v);
+    }
+}
+
+TEST_CASE("printer combinators")
+{
+    using namespace std::string_view_literals;
+
+    SUBCASE("print_seq")
+    {
+        const auto parse = ptcore::seq(
+            ptcore::match_integer<int>(), ptcore::match_char('='),
+            ptcore::match_run(ptcore::char_classes::alpha));
+        const auto print = ptcore::print_seq(
+            ptcore::print_integer<int>(), ptcore::print_char(),
+            ptcore::print_text());
+
+        const auto v = parse("-12=abc")->value;
+        CHECK(print_checked(print, v) == "-12=abc");
+        CHECK(print.size(v) == 7);
+    }
+
+    SUBCASE("print_n")
+    {
+        const auto parse = ptcore::match_n<4>(
+            ptcore::match_integer<std::uint8_t>(), ptcore::match_char('.'));
+        const auto print =
+            ptcore::print_n<4>(ptcore::print_integer<std::uint8_t>(), ".");
+
+        for (const auto text : { "192.168.0.1"sv, "0.0.0.0"sv,
+                                 "255.255.255.255"sv })
+        {
+            CHECK(print_checked(print, parse(text)->value) == text);
+        }
+    }
+
+    SUBCASE("print_sep_by")
+    {
+        const auto print = ptcore::print_sep_by(
+            ptcore::print_floating_point<double>(), ", ");
+
+        CHECK(print_checked(print, std::vector<double>{}) == "");
+        CHECK(print_checked(print, std::vector{ 1.5 }) == "1.5");
+        CHECK(print_checked(print, std::vector{ 1.5, -2.0, 1e-7 }) ==
+              "1.5, -2, 1e-07");
+    }
+
+    SUBCASE("arena")
+    {
+        std::pmr::monotonic_buffer_resource arena;
+        std::pmr::vector<char> out{ &arena };
+        std::pmr::string text{ &arena };
+
+        const auto print =
+            ptcore::print_sep_by(ptcore::print_integer<int>(), ",");
+        const std::vector<int> values{ 1, 22, 333 };
+        ptcore::print_append(print, out, values);
+        ptcore::print_append(ptcore::print_char(), out, '\n');
+        ptcore::print_append(print, out, values);
+        ptcore::print_append(print, text, values);
+
+        CHECK(std::string_view{ out.data(), out.size() } ==
+              "1,22,333\n1,22,333");
+        CHECK(text == "1,22,333");
+    }
+
+    SUBCASE("text beyond max_size")
+    {
+        struct overlong_printer
+        {
+            char* print(char* first, char* last, int) const
+            {
+                return ptcore::print_text().print(first, last, "overlong");
+            }
+
+            std::size_t max_size(int) const { return 4; }
+        };
+
+        std::string text = "ab";
+        REQUIRE_THROWS_AS(ptcore::print_append(overlong_printer{}, text, 0),
+                          std::length_error);
+        CHECK(text == "ab");
+
+        std::vector<char> out{ 'a', 'b' };
+        REQUIRE_THROWS_AS(ptcore::print_append(overlong_printer{}, out, 0),
+                          std::length_error);
+        CHECK(out == std::vector<char>{ 'a', 'b' });
+    }
+}
@@ -0,0 +1,224 @@
+#include <doctest/doctest.h>
+#include "ptcore/rational.h"
+
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <ratio>
+#include <stdexcept>
+#include <string_view>
+
+TEST_CASE("binary_gcd")
+{
+    using ptcore::detail::binary_gcd;
+
+    static_assert(binary_gcd(0u, 0u) == 0);
+    static_assert(binary_gcd(0u, 5u) == 5);
+    static_assert(binary_gcd(12u, 18u) == 6);
+    static_assert(binary_gcd(std::uint64_t{1} << 63, std::uint64_t{6}) == 2);
+
+    std::mt19937_64 rng{ 21 };
+    for (int i = 0; i < 10000; ++i)
+    {
+        const auto a = rng() >> (rng() % 64);
+        const auto b = rng() >> (rng() % 64);
+        REQUIRE(binary_gcd(a, b) == std::gcd(a, b));
+    }
+}
+
+TEST_CASE("int128")
+{
+    using ptcore::detail::int128;
+    constexpr auto max = std::numeric_limits<std::int64_t>::max();
+    constexpr auto min = std::numeric_limits<std::int64_t>::min();
+
+    static_assert(int128{ -1 } < 0 && int128{ -1 } < int128{ 1u });
+    static_assert(int128{ max } + 1 > max && -int128{ min } > max);
+    static_assert(static_cast<std::int64_t>(int128{ -5 }) == -5);
+    static_assert(int128{ -7 } / 2 == -3 && int128{ -7 } % 2 == -1);
+
+    // products past 64 bits, divided back one bit at a time
+    static_assert(int128{ max } * max / max == max);
+    static_assert((int128{ max } * max + 5) % max == 5);
+    static_assert((int128{ min } * max - 5) / max == min);
+    static_assert((int128{ min } * max - 5) % max == -5);
+    static_assert((int128{ min } * min - 1) / -int128{ min } == max);
+    static_assert((int128{ min } * min - 1) % min == max);
+
+#if defined(__SIZEOF_INT128__)
+    __extension__ using reference = __int128;
+
+    std::mt19937_64 rng{ 21 };
+    const auto term = [&]
+    {
+        return static_cast<std::int64_t>(rng() >> (rng() % 64));
+    };
+
+    // the same sign, low 64 bits and quotient by 2^64 make the same value
+    const auto same = [](int128 a, reference b)
+    {
+        constexpr std::uint64_t half = std::uint64_t{1} << 32;
+        return (a < 0) == (b < 0) &&
+               static_cast<std::uint64_t>(a) ==
+                   static_cast<std::uint64_t>(b) &&
+               static_cast<std::int64_t>(a / half / half) ==
+                   static_cast<std::int64_t>(b / half / half);
+    };
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        const auto a = term();
+        const auto b = term();
+        const auto c = term();
+        const auto d = term() | 1;
+
+        const int128 x = int128{ a } * b + c;
+        const reference y = reference{ a } * b + c;
+        REQUIRE(same(x, y));
+        REQUIRE(same(-x, -y));
+        REQUIRE(same(x / d, y / d));
+        REQUIRE(same(x % d, y % d));
+        REQUIRE(same(x / (int128{ d } * c + 1),
+                     y / (reference{ d } * c + 1)));
+        REQUIRE((x < int128{ b }) == (y < b));
+    }
+#endif
+}
+
+TEST_CASE("rational")
+{
+    using ptcore::rational;
+    using r64 = rational<std::int64_t>;
+    constexpr auto max = std::numeric_limits<std::int64_t>::max();
+    constexpr auto min = std::numeric_limits<std::int64_t>::min();
+
+    SUBCASE("normalization")
+    {
+        static_assert(r64{}.num() == 0 && r64{}.den() == 1);
+        static_assert(r64{ 6, -4 }.num() == -3 && r64{ 6, -4 }.den() == 2);
+        static_assert(r64{ 0, -7 }.den() == 1);
+        static_assert(r64{ min, -2 }.num() == std::int64_t{1} << 62);
+        static_assert(r64{ min, min }.num() == 1);
+
+        REQUIRE_THROWS_AS(r64(1, 0), std::invalid_argument);
+        REQUIRE_THROWS_AS(r64(min, -1), std::overflow_error);
+    }
+
+    SUBCASE("ratio interop")
+    {
+        static_assert(r64{ std::ratio<6, -4>{} } == r64{ -3, 2 });
+        static_assert(r64{ 1, 1000 } == std::milli{});
+        static_assert(std::kilo{} == r64{ 1000 });
+        static_assert(rational{ std::nano{} }.den() == 1'000'000'000);
+        static_assert(!std::is_constructible_v<rational<std::int32_t>,
+                                               std::tera>);
+        static_assert(std::is_constructible_v<rational<std::int32_t>,
+                                              std::mega>);
+    }
+
+    SUBCASE("arithmetic")
+    {
+        static_assert(r64{ 1, 6 } + r64{ 1, 3 } == r64{ 1, 2 });
+        static_assert(r64{ 1, 6 } - r64{ 1, 6 } == r64{});
+        static_assert(r64{ 2, 3 } * r64{ 9, 4 } == r64{ 3, 2 });
+        static_assert(r64{ 2, 3 } / r64{ -4, 9 } == r64{ -3, 2 });
+        static_assert(-r64{ 1, 2 } == r64{ -1, 2 });
+        static_assert(r64{ 1, 3 } < r64{ 1, 2 });
+        static_assert(r64{ max } > r64{ max - 1, 1 });
+        static_assert(static_cast<double>(r64{ 3, 4 }) == 0.75);
+
+        auto x = r64{ 1, 2 };
+        x += r64{ 1, 4 };
+        x *= r64{ 4 };
+        x -= r64{ 1 };
+        x /= r64{ 4 };
+        CHECK(x == r64{ 1, 2 });
+
+        // intermediates wider than 64 bits reduce back into range
+        CHECK(r64{ max, 3 } * r64{ 3, max } == r64{ 1 });
+        CHECK(r64{ -1 } - r64{ min } == r64{ max });
+        CHECK(r64{ min } / r64{ min } == r64{ 1 });
+        CHECK(r64{ 2 } / r64{ min } == r64{ -1, std::int64_t{1} << 62 });
+
+        REQUIRE_THROWS_AS(r64{ max } + r64{ 1 }, std::overflow_error);
+        REQUIRE_THROWS_AS(r64{ max } * r64{ 2 }, std::overflow_error);
+        REQUIRE_THROWS_AS(-r64{ min }, std::overflow_error);
+        REQUIRE_THROWS_AS(r64(1, max) + r64(1, max - 1),
+                          std::overflow_error);
+        REQUIRE_THROWS_AS(r64{ 1 } / r64{}, std::domain_error);
+    }
+
+    SUBCASE("constant operands")
+    {
+        static_assert(r64{ 1, 3 } + std::ratio<2>{} == r64{ 7, 3 });
+        static_assert(r64{ 1, 3 } - std::ratio<1, 6>{} == r64{ 1, 6 });
+        static_assert(std::ratio<1>{} - r64{ 1, 3 } == r64{ 2, 3 });
+        static_assert(r64{ 10, 3 } * std::milli{} == r64{ 1, 300 });
+        static_assert(std::kilo{} * r64{ 3, 10 } == r64{ 300 });
+        static_assert(r64{ 3, 4 } * std::ratio<-2, 3>{} == r64{ -1, 2 });
+        static_assert(r64{ 3, 4 } * std::ratio<0>{} == r64{});
+        static_assert(r64{ 3, 4 } / std::ratio<-3, 8>{} == r64{ -2 });
+
+        REQUIRE_THROWS_AS(r64{ max } + std::ratio<1>{}, std::overflow_error);
+    }
+
+    SUBCASE("matches the generic operators")
+    {
+        using r32 = rational<std::int32_t>;
+
+        std::mt19937 rng{ 21 };
+        const auto term = [&] {
+            return static_cast<std::int32_t>(rng() % 2001) - 1000;
+        };
+
+        for (int i = 0; i < 10000; ++i)
+        {
+            const auto d1 = term();
+            const auto d2 = term();
+            if (d1 == 0 || d2 == 0)
+            {
+                continue;
+            }
+
+            const r32 a{ term(), d1 };
+            const r32 b{ term(), d2 };
+
+            const auto sum = a + b;
+            const auto product = a * b;
+            REQUIRE(std::gcd(sum.num(), sum.den()) == 1);
+            REQUIRE(std::gcd(product.num(), product.den()) == 1);
+            REQUIRE(sum.den() > 0);
+            REQUIRE(std::int64_t{ sum.num() } * a.den() * b.den() ==
+                    (std::int64_t{ a.num() } * b.den() +
+                     std::int64_t{ b.num() } * a.den()) *
+                        sum.den());
+            REQUIRE(a - b + b == a);
+            if (b != r32{})
+            {
+                REQUIRE(a / b * b == a);
+            }
+
+            REQUIRE(a * std::ratio<-6, 35>{} == a * r32{ -6, 35 });
+            REQUIRE(a + std::ratio<-6, 35>{} == a + r32{ -6, 35 });
+            REQUIRE(a + std::ratio<7>{} == a + r32{ 7 });
+        }
+    }
+}
+
+TEST_CASE("match_rational")
+{
+    using namespace std::string_view_literals;
+    using r64 = ptcore::rational<std::int64_t>;
+
+    constexpr auto p = ptcore::match_rational<std::int64_t>();
+
+    static_assert(p("12")->value == r64{ 12 });
+    static_assert(p("-6/8x")->value == r64{ -3, 4 });
+    static_assert(p("-6/8x")->remaining_input == "x"sv);
+    static_assert(!p("3/"));
+    static_assert(!p("3/0"));
+    static_assert(!p("3/-4"));
+    static_assert(!p("x"));
+    static_assert(!p("99999999999999999999"));
+}
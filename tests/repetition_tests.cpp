@@ -0,0 +1,118 @@
+#include <doctest/doctest.h>
+#include "ptcore/repetition.h"
+#include "ptcore/char_parsers.h"
+#include "ptcore/numeric.h"
+
+#include <array>
+#include <memory_resource>
+#include <optional>
+#include <string_view>
+#include <tuple>
+
+TEST_CASE("repeat")
+{
+    using namespace std::string_view_literals;
+    using ptcore::inline_vector;
+
+    constexpr auto digit = ptcore::match_char(ptcore::char_classes::digit);
+
+    SUBCASE("repeat")
+    {
+        constexpr auto p = ptcore::repeat<2, 3>(digit);
+        using vector_t = inline_vector<char, 3>;
+
+        static_assert(!p("1a"));
+        static_assert(p("12a")->value == vector_t{ '1', '2' });
+        static_assert(p("12a")->remaining_input == "a"sv);
+        static_assert(p("1234")->value == vector_t{ '1', '2', '3' });
+        static_assert(p("1234")->remaining_input == "4"sv);
+    }
+
+    SUBCASE("many")
+    {
+        constexpr auto p = ptcore::many<4>(digit);
+
+        static_assert(p("")->value.empty());
+        static_assert(p("x")->remaining_input == "x"sv);
+        static_assert(p("123456")->value.size() == 4);
+        static_assert(p("123456")->remaining_input == "56"sv);
+    }
+
+    SUBCASE("no progress")
+    {
+        constexpr auto p = ptcore::many<8>(
+            ptcore::skip_while(ptcore::char_classes::space));
+
+        static_assert(p("x")->value.size() == 1);
+        static_assert(p("  x")->value.size() == 2);
+        static_assert(p("  x")->remaining_input == "x"sv);
+    }
+}
+
+TEST_CASE("sep_by")
+{
+    using namespace std::string_view_literals;
+    using ptcore::inline_vector;
+    using vector_t = inline_vector<int, 4>;
+
+    constexpr auto p = ptcore::sep_by<4>(ptcore::match_integer<int>(),
+                                         ptcore::match_char(','));
+
+    constexpr std::array test_values =
+    {
+        std::tuple{ ""sv, vector_t{}, ""sv },
+        std::tuple{ "x"sv, vector_t{}, "x"sv },
+        std::tuple{ "1"sv, vector_t{ 1 }, ""sv },
+        std::tuple{ "1,"sv, vector_t{ 1 }, ","sv },
+        std::tuple{ "1,x"sv, vector_t{ 1 }, ",x"sv },
+        std::tuple{ "1,2,3"sv, vector_t{ 1, 2, 3 }, ""sv },
+        std::tuple{ "1,2,3,4,5"sv, vector_t{ 1, 2, 3, 4 }, ",5"sv }
+    };
+
+    for (int i = 0; auto const& [text, values, remaining] : test_values)
+    {
+        CAPTURE(i++);
+
+        const auto r = p(text);
+        REQUIRE(r.has_value());
+        REQUIRE(r->value == values);
+        REQUIRE(r->remaining_input == remaining);
+    }
+
+    static_assert(p("1,2")->value == vector_t{ 1, 2 });
+}
+
+TEST_CASE("repetition into a memory resource")
+{
+    using namespace std::string_view_literals;
+
+    // the upstream resource throws, so any allocation outside of the
+    // buffer would fail the test
+    std::array<std::byte, 4096> buffer;
+    std::pmr::monotonic_buffer_resource arena{
+        buffer.data(), buffer.size(), std::pmr::null_memory_resource() };
+
+    SUBCASE("many")
+    {
+        const auto p = ptcore::many(
+            ptcore::match_char(ptcore::char_classes::alpha), &arena);
+
+        const auto r = p("abcdefghijklmnopqrstuvwxyz0");
+        REQUIRE(r.has_value());
+        REQUIRE(r->value.size() == 26);
+        REQUIRE(r->value.get_allocator().resource() == &arena);
+        REQUIRE(r->remaining_input == "0"sv);
+    }
+
+    SUBCASE("sep_by")
+    {
+        const auto p = ptcore::sep_by(ptcore::match_integer<int>(),
+                                      ptcore::match_char(','), &arena);
+
+        const auto r = p("1,2,3,4,5,6,7,8,9,10;");
+        REQUIRE(r.has_value());
+        REQUIRE(r->value.size() == 10);
+        REQUIRE(r->value.back() == 10);
+        REQUIRE(r->remaining_input == ";"sv);
+    }
+}
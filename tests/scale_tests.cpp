@@ -0,0 +1,174 @@
+#include <doctest/doctest.h>
+#include "ptcore/scale.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <ratio>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    using ptcore::rounding;
+
+    using ptcore::detail::int128;
+
+    // x * R rounded as Mode says, in exact 128 bit arithmetic.
+    template <typename R, rounding Mode>
+    int128 reference_scale(int128 x)
+    {
+        const int128 p = x * R::num;
+        int128 q = p / R::den;
+        const int128 r = p % R::den;
+        if (r != 0)
+        {
+            if constexpr (Mode == rounding::floor)
+            {
+                q = q - (p < 0 ? 1 : 0);
+            }
+            else if constexpr (Mode == rounding::ceil)
+            {
+                q = q + (p > 0 ? 1 : 0);
+            }
+            else if constexpr (Mode == rounding::nearest)
+            {
+                const int128 twice = 2 * (r < 0 ? -r : r);
+                if (twice >= R::den)
+                {
+                    q = q + (p < 0 ? -1 : 1);
+                }
+            }
+        }
+
+        return q;
+    }
+
+    template <typename T>
+    std::vector<T> test_values(std::size_t n)
+    {
+        constexpr auto min = std::numeric_limits<T>::min();
+        constexpr auto max = std::numeric_limits<T>::max();
+
+        std::vector<T> ret{ 0, 1, 2, 3, 7, 999, 1000, 1001, 3599, 3600,
+                            min, max, T(min + 1), T(max - 1) };
+        if constexpr (std::is_signed_v<T>)
+        {
+            ret.insert(ret.end(), { -1, -2, -3, -999, -1000, -1001, -3600 });
+        }
+
+        std::mt19937_64 rng{ 22 };
+        while (ret.size() < n)
+        {
+            ret.push_back(static_cast<T>(rng() >> (rng() % 64)));
+        }
+
+        return ret;
+    }
+
+    template <typename R, rounding Mode, typename T, typename U>
+    void check_scale()
+    {
+        const auto in = test_values<T>(1003);
+        std::vector<U> out(in.size());
+
+        // every length, for the tails of the vector loop
+        for (std::size_t n : { 0, 1, 7, 8, 9, 16, 31, 1003 })
+        {
+            ptcore::scale<R, Mode>(std::span<const T>{ in.data(), n },
+                                   std::span<U>{ out });
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                CAPTURE(i);
+                CAPTURE(static_cast<std::int64_t>(in[i]));
+                REQUIRE(out[i] ==
+                        static_cast<U>(reference_scale<R, Mode>(in[i])));
+            }
+        }
+    }
+
+    template <typename R, typename T, typename U>
+    void check_all_modes()
+    {
+        check_scale<R, rounding::toward_zero, T, U>();
+        check_scale<R, rounding::floor, T, U>();
+        check_scale<R, rounding::ceil, T, U>();
+        check_scale<R, rounding::nearest, T, U>();
+    }
+
+    template <typename R>
+    void check_ratio()
+    {
+        check_all_modes<R, std::int32_t, std::int32_t>();
+        check_all_modes<R, std::uint32_t, std::uint32_t>();
+        check_all_modes<R, std::int64_t, std::int64_t>();
+        check_all_modes<R, std::uint64_t, std::uint64_t>();
+        check_all_modes<R, std::int32_t, std::int64_t>();
+        check_all_modes<R, std::int16_t, std::int32_t>();
+    }
+}
+
+TEST_CASE("reciprocal")
+{
+    using ptcore::detail::reciprocal;
+
+    std::mt19937_64 rng{ 22 };
+    for (int i = 0; i < 1000; ++i)
+    {
+        const auto d32 = static_cast<std::uint32_t>(rng() >> (rng() % 32)) | 1;
+        const auto d64 = (rng() >> (rng() % 64)) | 1;
+        const reciprocal<std::uint32_t> r32{ d32 };
+        const reciprocal<std::uint64_t> r64{ d64 };
+        for (int j = 0; j < 100; ++j)
+        {
+            const auto x = rng() >> (rng() % 64);
+            REQUIRE(r64.divide(x) == x / d64);
+            REQUIRE(r32.divide(std::uint32_t(x)) == std::uint32_t(x) / d32);
+        }
+    }
+
+    for (const std::uint64_t d : { std::uint64_t{1}, std::uint64_t{2},
+                                   std::uint64_t{1} << 63,
+                                   ~std::uint64_t{0} })
+    {
+        const reciprocal<std::uint64_t> r{ d };
+        CHECK(r.divide(~std::uint64_t{0}) == ~std::uint64_t{0} / d);
+        CHECK(r.divide(d - 1) == 0);
+        CHECK(r.divide(d) == 1);
+    }
+}
+
+TEST_CASE("scale")
+{
+    using ptcore::rounding;
+
+    static_assert(ptcore::scale<std::milli>(1999) == 1);
+    static_assert(ptcore::scale<std::milli>(-1999) == -1);
+    static_assert(ptcore::scale<std::milli, rounding::floor>(-1999) == -2);
+    static_assert(ptcore::scale<std::milli, rounding::ceil>(1001) == 2);
+    static_assert(ptcore::scale<std::milli, rounding::nearest>(1500) == 2);
+    static_assert(ptcore::scale<std::milli, rounding::nearest>(-1499) ==
+                  -1);
+    static_assert(ptcore::scale<std::kilo, rounding::toward_zero,
+                                std::int64_t>(3'000'000) ==
+                  3'000'000'000);
+
+    check_ratio<std::milli>();
+    check_ratio<std::kilo>();
+    check_ratio<std::ratio<1>>();
+    check_ratio<std::ratio<0>>();
+    check_ratio<std::ratio<1, 2>>();
+    check_ratio<std::ratio<3, 7>>();
+    check_ratio<std::ratio<-5, 3>>();
+    check_ratio<std::ratio<1, 3600>>();
+    check_ratio<std::ratio<1'000'000'007, 3>>();
+    check_ratio<std::ratio<1, 4'294'967'291>>();
+    check_ratio<std::ratio<3, 1ll << 40>>();
+
+    std::vector<int> in(4);
+    std::vector<int> out(3);
+    REQUIRE_THROWS_AS(ptcore::scale<std::milli>(std::span<const int>{ in },
+                                                std::span<int>{ out }),
+                      std::length_error);
+}
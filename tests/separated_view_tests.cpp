@@ -0,0 +1,116 @@
+#include <doctest/doctest.h>
+#include "ptcore/separated_view.h"
+#include "ptcore/char_parsers.h"
+#include "ptcore/numeric.h"
+
+#include <ranges>
+#include <string_view>
+#include <vector>
+
+TEST_CASE("separated_view")
+{
+    using namespace std::string_view_literals;
+    using ptcore::match_char;
+    using ptcore::match_integer;
+
+    static_assert(std::ranges::input_range<
+                  decltype(ptcore::separated(match_integer<int>(),
+                                             match_char(','), ""))>);
+    static_assert(std::ranges::view<
+                  decltype(ptcore::separated(match_integer<int>(),
+                                             match_char(','), ""))>);
+
+    SUBCASE("all elements")
+    {
+        auto v = ptcore::separated(match_integer<int>(), match_char(','),
+                                   "1,2,3;rest");
+
+        std::vector<int> values;
+        for (const auto i : v)
+        {
+            values.push_back(i);
+        }
+
+        REQUIRE(values == std::vector{ 1, 2, 3 });
+        REQUIRE(v.remaining_input() == ";rest"sv);
+        REQUIRE(!v.failed());
+    }
+
+    SUBCASE("failure")
+    {
+        auto v = ptcore::separated(match_integer<int>(), match_char(','),
+                                   "1,2,x");
+
+        std::vector<int> values;
+        for (const auto i : v)
+        {
+            values.push_back(i);
+        }
+
+        REQUIRE(values == std::vector{ 1, 2 });
+        REQUIRE(v.remaining_input() == ",x"sv);
+        REQUIRE(v.failed());
+
+        auto empty = ptcore::separated(match_integer<int>(), match_char(','),
+                                       "");
+        REQUIRE(empty.begin() == empty.end());
+        REQUIRE(empty.failed());
+    }
+
+    SUBCASE("pipelines stop early")
+    {
+        int calls = 0;
+        const auto counting = [&](ptcore::parse_input_t s)
+        {
+            ++calls;
+            return match_integer<int>()(s);
+        };
+
+        auto v = ptcore::separated(counting, match_char(','),
+                                   "1,2,3,4,5,6,7,8,9,10");
+        std::vector<int> values;
+        for (const auto i : std::ranges::ref_view{ v } | std::views::take(3))
+        {
+            values.push_back(i);
+        }
+
+        REQUIRE(values == std::vector{ 1, 2, 3 });
+        REQUIRE(calls == 3);
+        REQUIRE(v.remaining_input() == ",4,5,6,7,8,9,10"sv);
+
+        // filter looks for the next match when it is advanced, so it
+        // parses up to the element after the last one taken
+        calls = 0;
+        auto v2 = ptcore::separated(counting, match_char(','),
+                                    "1,2,3,4,5,6,7,8,9,10");
+        values.clear();
+        for (const auto i : std::ranges::ref_view{ v2 }
+                 | std::views::filter([](int i) { return i % 2 == 0; })
+                 | std::views::transform([](int i) { return i * 10; })
+                 | std::views::take(2))
+        {
+            values.push_back(i);
+        }
+
+        REQUIRE(values == std::vector{ 20, 40 });
+        REQUIRE(calls == 6);
+        REQUIRE(v2.remaining_input() == ",7,8,9,10"sv);
+    }
+
+    SUBCASE("constexpr")
+    {
+        constexpr auto sum = []
+        {
+            int ret = 0;
+            for (const auto i : ptcore::separated(match_integer<int>(),
+                                                  match_char(' '),
+                                                  "10 20 30"))
+            {
+                ret += i;
+            }
+            return ret;
+        }();
+
+        static_assert(sum == 60);
+    }
+}
@@ -0,0 +1,142 @@
+#include <doctest/doctest.h>
+#include "ptcore/separator_index.h"
+#include "ptcore/char_parsers.h"
+#include "ptcore/numeric.h"
+
+#include <array>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+    // byte at a time reference for the structural positions
+    std::vector<std::size_t> reference_positions(
+        std::string_view s, ptcore::structural_separator sep)
+    {
+        std::vector<std::size_t> ret;
+        bool quoted = false;
+        for (std::size_t i = 0; i < s.size(); ++i)
+        {
+            if (sep.escape && s[i] == *sep.escape)
+            {
+                ++i;
+            }
+            else if (sep.quote && s[i] == *sep.quote)
+            {
+                quoted = !quoted;
+            }
+            else if (s[i] == sep.separator && !quoted)
+            {
+                ret.push_back(i);
+            }
+        }
+        return ret;
+    }
+}
+
+TEST_CASE("separator_index")
+{
+    using namespace std::string_view_literals;
+    using ptcore::separator_index;
+    using ptcore::structural_separator;
+
+    SUBCASE("fields")
+    {
+        const separator_index index{ "a,b,,c"sv, { ',' } };
+
+        REQUIRE(index.field_count() == 4);
+        REQUIRE(index.field(0) == "a"sv);
+        REQUIRE(index.field(1) == "b"sv);
+        REQUIRE(index.field(2) == ""sv);
+        REQUIRE(index.field(3) == "c"sv);
+
+        REQUIRE(separator_index{ ""sv, { ',' } }.field_count() == 1);
+    }
+
+    SUBCASE("quotes and escapes")
+    {
+        const structural_separator sep{ ',', '"', '\\' };
+
+        const separator_index index{ R"(a,"b,c",d\,e,"f\",g",\\,h)"sv, sep };
+
+        REQUIRE(index.field_count() == 6);
+        REQUIRE(index.field(1) == R"("b,c")"sv);
+        REQUIRE(index.field(2) == R"(d\,e)"sv);
+        REQUIRE(index.field(3) == R"("f\",g")"sv);
+        REQUIRE(index.field(4) == R"(\\)"sv);
+        REQUIRE(index.field(5) == "h"sv);
+    }
+
+    SUBCASE("matches a byte at a time scan")
+    {
+        std::mt19937 rng{ 1234 };
+        constexpr std::string_view alphabet = "ab,,\"\\";
+
+        const std::array separators =
+        {
+            structural_separator{ ',' },
+            structural_separator{ ',', '"' },
+            structural_separator{ ',', '"', '\\' }
+        };
+
+        for (int i = 0; i < 500; ++i)
+        {
+            CAPTURE(i);
+
+            std::string text(rng() % 300, ' ');
+            for (auto& ch : text)
+            {
+                ch = alphabet[rng() % alphabet.size()];
+            }
+
+            for (auto const& sep : separators)
+            {
+                const separator_index index{ text, sep };
+                const auto expected = reference_positions(text, sep);
+
+                REQUIRE(std::vector<std::size_t>(index.positions().begin(),
+                                                 index.positions().end()) ==
+                        expected);
+            }
+        }
+    }
+}
+
+TEST_CASE("match_n_count with a separator_index")
+{
+    using namespace std::string_view_literals;
+    using ptcore::match_n_count;
+
+    const auto p = ptcore::match_integer<int>();
+
+    std::array test_values =
+    {
+        ""sv,
+        "C"sv,
+        "1"sv,
+        "1 "sv,
+        "1|"sv,
+        "1|C"sv,
+        "1|2"sv,
+        "1|2 "sv,
+        "1|2|"sv,
+        "1|2|3|4|5|6|7|8|9|10|11|12|13|14|15|16|17|18|19|20|21|22|23|24"sv,
+        "1|2|3|4|5|6|7|8|9|10|11|12|13|14|15|16|17|18|19|20|21|22|23|x4"sv
+    };
+
+    for (int i = 0; auto const& text : test_values)
+    {
+        CAPTURE(i++);
+
+        const auto expected = match_n_count(p, ptcore::match_char('|'), text);
+        const auto result =
+            match_n_count(p, ptcore::structural_separator{ '|' }, text);
+
+        REQUIRE(result.count == expected.count);
+        REQUIRE(result.full_match == expected.full_match);
+    }
+}
@@ -0,0 +1,70 @@
+#include <doctest/doctest.h>
+#include "ptcore/static_table.h"
+#include "ptcore/char_parsers.h"
+#include "ptcore/numeric.h"
+
+#include <algorithm>
+#include <array>
+#include <string_view>
+
+namespace
+{
+    using namespace std::string_view_literals;
+
+    constexpr auto primes_text = [] { return "7\n2\n\n5\r\n3\n  \n11"sv; };
+
+    constexpr auto units_text = [] {
+        return "second=1\n"
+               "minute=60\r\n"
+               "\n"
+               "hour=3600\n"
+               "day=86400\n"sv;
+    };
+
+    constexpr char embedded[] = { 'b', '=', '2', '\n', 'a', '=', '1' };
+}
+
+TEST_CASE("parse_static_rows")
+{
+    constexpr auto rows = ptcore::parse_static_rows<primes_text>(
+        ptcore::match_integer<int>());
+    static_assert(rows == std::array{ 7, 2, 5, 3, 11 });
+
+    constexpr auto sorted = ptcore::parse_static_sorted<primes_text>(
+        ptcore::match_integer<int>());
+    static_assert(sorted == std::array{ 2, 3, 5, 7, 11 });
+    static_assert(std::binary_search(sorted.begin(), sorted.end(), 5));
+
+    constexpr auto empty = ptcore::parse_static_rows<[] { return "\n\n"sv; }>(
+        ptcore::match_integer<int>());
+    static_assert(empty.empty());
+}
+
+TEST_CASE("parse_static_map")
+{
+    constexpr auto units = ptcore::parse_static_map<units_text>(
+        ptcore::match_run(ptcore::char_classes::alpha),
+        ptcore::match_char('='),
+        ptcore::match_integer<int>());
+
+    static_assert(units.size() == 4);
+    static_assert(*units.find("minute") == 60);
+    static_assert(*units.find("day") == 86400);
+    static_assert(!units.find("week"));
+    static_assert(!units.contains(""));
+    static_assert(units.begin()->first == "day"sv);
+    static_assert(std::is_sorted(units.begin(), units.end()));
+
+    // the text of an array that is not null terminated, as from #embed
+    constexpr auto from_array = ptcore::parse_static_map<[] {
+        return std::string_view{ embedded, sizeof(embedded) };
+    }>(ptcore::match_run(ptcore::char_classes::alpha),
+       ptcore::match_char('='),
+       ptcore::match_integer<int>());
+
+    static_assert(*from_array.find("a") == 1);
+    static_assert(*from_array.find("b") == 2);
+
+    CHECK(units.find("hour") != nullptr);
+    CHECK(*units.find("hour") == 3600);
+}
@@ -0,0 +1,177 @@
+#include <doctest/doctest.h>
+#include "ptcore/stream.h"
+#include "ptcore/char_parsers.h"
+#include "ptcore/combinators.h"
+#include "ptcore/numeric.h"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+    struct stream_results
+    {
+        std::vector<int> values;
+        ptcore::parse_status status;
+        std::size_t max_carry{0};
+        std::size_t fed{0};
+    };
+
+    // Parses text fed in chunks of chunk_size bytes.
+    template <typename P>
+    stream_results parse_chunked(P const& p,
+                                 std::string_view text,
+                                 std::size_t chunk_size)
+    {
+        using ptcore::parse_status;
+
+        stream_results ret;
+        ptcore::stream_parser sp{ p };
+
+        for (;;)
+        {
+            const auto status = sp.next();
+            ret.max_carry = std::max(ret.max_carry, sp.carry_size());
+
+            if (status == parse_status::complete)
+            {
+                ret.values.push_back(std::get<0>(sp.value()));
+            }
+            else if (status == parse_status::need_more_input)
+            {
+                if (text.empty())
+                {
+                    sp.finish();
+                }
+                else
+                {
+                    const auto n = std::min(chunk_size, text.size());
+                    sp.feed(text.substr(0, n));
+                    text.remove_prefix(n);
+                    ret.fed += n;
+                }
+            }
+            else
+            {
+                ret.status = status;
+                return ret;
+            }
+        }
+    }
+}
+
+TEST_CASE("stream_parser")
+{
+    using namespace std::string_view_literals;
+    using ptcore::parse_status;
+
+    const auto line =
+        ptcore::seq(ptcore::match_integer<int>(), ptcore::match_char('\n'));
+
+    std::string text;
+    std::vector<int> expected;
+    for (int i = 0; i < 200; ++i)
+    {
+        expected.push_back(i * 7919 - 300000);
+        text += std::to_string(expected.back()) + "\n";
+    }
+
+    SUBCASE("any chunk size gives the same values")
+    {
+        for (std::size_t chunk_size = 1; chunk_size <= 40; ++chunk_size)
+        {
+            CAPTURE(chunk_size);
+
+            const auto r = parse_chunked(line, text, chunk_size);
+            REQUIRE(r.status == parse_status::end_of_input);
+            REQUIRE(r.values == expected);
+
+            // the carry only ever holds the end of a line plus the first
+            // bytes of the next chunk
+            REQUIRE(r.max_carry <= 24);
+        }
+    }
+
+    SUBCASE("a value at the end of a chunk waits for more input")
+    {
+        const auto number = ptcore::match_integer<int>();
+        ptcore::stream_parser sp{ number };
+
+        sp.feed("12");
+        REQUIRE(sp.next() == parse_status::need_more_input);
+        sp.feed("34");
+        REQUIRE(sp.next() == parse_status::need_more_input);
+        sp.finish();
+        REQUIRE(sp.next() == parse_status::complete);
+        REQUIRE(sp.value() == 1234);
+        REQUIRE(sp.next() == parse_status::end_of_input);
+    }
+
+    SUBCASE("a value that reaches its maximum length is complete")
+    {
+        ptcore::stream_parser sp{ ptcore::match_char(
+            ptcore::char_classes::alpha) };
+
+        sp.feed("ab");
+        REQUIRE(sp.next() == parse_status::complete);
+        REQUIRE(sp.value() == 'a');
+        REQUIRE(sp.next() == parse_status::complete);
+        REQUIRE(sp.value() == 'b');
+        REQUIRE(sp.next() == parse_status::need_more_input);
+    }
+
+    SUBCASE("failures")
+    {
+        // a byte that cannot start a value fails without waiting
+        const auto r = parse_chunked(line, "1\n2\nx\n", 5);
+        REQUIRE(r.values == std::vector{ 1, 2 });
+        REQUIRE(r.status == parse_status::failed);
+
+        // an incomplete value at the end of the stream fails
+        const auto r2 = parse_chunked(line, "1\n2\n3", 3);
+        REQUIRE(r2.values == std::vector{ 1, 2 });
+        REQUIRE(r2.status == parse_status::failed);
+    }
+
+    SUBCASE("a malformed value fails without reading the rest")
+    {
+        std::string bad = "1\n2x\n";
+        for (int i = 0; i < 3000; ++i)
+        {
+            bad += "1234\n";
+        }
+
+        for (std::size_t chunk_size = 1; chunk_size <= 8; ++chunk_size)
+        {
+            CAPTURE(chunk_size);
+
+            const auto r = parse_chunked(line, bad, chunk_size);
+            REQUIRE(r.values == std::vector{ 1 });
+            REQUIRE(r.status == parse_status::failed);
+
+            // the stream stops in the chunk that holds the 'x'
+            REQUIRE(r.fed < 4 + chunk_size);
+            REQUIRE(r.max_carry <= 8);
+        }
+    }
+
+    SUBCASE("long values are bounded by max_token_size")
+    {
+        ptcore::stream_parser sp{
+            ptcore::match_run(ptcore::char_classes::alpha),
+            ptcore::stream_options{ 100 } };
+
+        const std::string letters(10, 'a');
+        auto status = sp.next();
+        while (status == parse_status::need_more_input)
+        {
+            sp.feed(letters);
+            status = sp.next();
+        }
+
+        REQUIRE(status == parse_status::failed);
+        REQUIRE(sp.carry_size() <= 110);
+    }
+}
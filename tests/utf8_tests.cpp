@@ -0,0 +1,227 @@
+#include <doctest/doctest.h>
+#include "ptcore/utf8.h"
+#include "ptcore/char_class.h"
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include <string_view>
+
+namespace
+{
+    std::string encode(char32_t c)
+    {
+        std::string ret;
+        if (c < 0x80)
+        {
+            ret += static_cast<char>(c);
+        }
+        else if (c < 0x800)
+        {
+            ret += static_cast<char>(0xc0 | (c >> 6));
+            ret += static_cast<char>(0x80 | (c & 0x3f));
+        }
+        else if (c < 0x10000)
+        {
+            ret += static_cast<char>(0xe0 | (c >> 12));
+            ret += static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+            ret += static_cast<char>(0x80 | (c & 0x3f));
+        }
+        else
+        {
+            ret += static_cast<char>(0xf0 | (c >> 18));
+            ret += static_cast<char>(0x80 | ((c >> 12) & 0x3f));
+            ret += static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+            ret += static_cast<char>(0x80 | (c & 0x3f));
+        }
+        return ret;
+    }
+
+    // Checks every available implementation against the scalar one.
+    void check_validators(std::string_view s)
+    {
+        const auto expected = ptcore::detail::validate_utf8_scalar(s, 0);
+        REQUIRE(ptcore::validate_utf8(s) == expected);
+
+#if PTCORE_SIMD_X86
+        const auto level = ptcore::detail::cpu_simd_level();
+        if (level != ptcore::detail::simd_level::scalar)
+        {
+            REQUIRE(ptcore::detail::validate_utf8_ssse3(s) == expected);
+        }
+
+        if (level == ptcore::detail::simd_level::avx2)
+        {
+            REQUIRE(ptcore::detail::validate_utf8_avx2(s) == expected);
+        }
+#endif
+    }
+}
+
+TEST_CASE("validate_utf8")
+{
+    using namespace std::string_view_literals;
+
+    static_assert(ptcore::is_valid_utf8(""));
+    static_assert(ptcore::is_valid_utf8("plain ASCII"));
+    static_assert(ptcore::is_valid_utf8(
+        "na\xc3\xafve \xe2\x82\xac \xf0\x9f\x98\x80"));
+
+    // overlong, surrogate, too large, stray continuation, truncated
+    static_assert(ptcore::validate_utf8("ab\xc0\xaf") == 2);
+    static_assert(ptcore::validate_utf8("a\xe0\x9f\xbf") == 1);
+    static_assert(ptcore::validate_utf8("\xed\xa0\x80") == 0);
+    static_assert(ptcore::validate_utf8("\xf4\x90\x80\x80") == 0);
+    static_assert(ptcore::validate_utf8("\xf5\x80\x80\x80") == 0);
+    static_assert(ptcore::validate_utf8("abc\x80") == 3);
+    static_assert(ptcore::validate_utf8("abc\xe2\x82") == 3);
+
+    SUBCASE("every code point")
+    {
+        std::string text;
+        for (char32_t c = 0; c <= 0x10ffff; ++c)
+        {
+            if (c < 0xd800 || c > 0xdfff)
+            {
+                const auto e = encode(c);
+                REQUIRE(ptcore::decode_utf8(e).value == c);
+                REQUIRE(ptcore::decode_utf8(e).length == e.size());
+                text += e;
+            }
+        }
+
+        check_validators(text);
+        CHECK(ptcore::is_valid_utf8(text));
+
+        for (char32_t c = 0xd800; c <= 0xdfff; ++c)
+        {
+            REQUIRE(ptcore::decode_utf8(encode(c)).length == 0);
+        }
+    }
+
+    SUBCASE("errors at every offset")
+    {
+        const std::string_view bad[] = {
+            "\x80", "\xbf", "\xc0\x80", "\xc1\xbf", "\xc2", "\xc2\x41",
+            "\xe0\x80\x80", "\xe0\xa0", "\xed\xbf\xbf", "\xef\xbf",
+            "\xf0\x8f\xbf\xbf", "\xf4\x90\x80\x80", "\xf0\x90\x80",
+            "\xf8\x88\x80\x80\x80", "\xff", "\xe2\x82\xac\x80"
+        };
+
+        for (auto const& b : bad)
+        {
+            for (std::size_t offset = 0; offset < 80; ++offset)
+            {
+                for (const auto* fill : { "a", "\xc3\xa9", "\xe2\x82\xac" })
+                {
+                    std::string text;
+                    while (text.size() < offset)
+                    {
+                        text += fill;
+                    }
+                    const auto valid = text.size();
+                    text += b;
+                    text += "tail of the input that is long enough";
+
+                    CAPTURE(offset);
+                    check_validators(text);
+                    CHECK(ptcore::validate_utf8(text) >= valid);
+                    CHECK(!ptcore::is_valid_utf8(text));
+                }
+            }
+        }
+    }
+
+    SUBCASE("random input")
+    {
+        std::mt19937 rng{ 18 };
+        const char32_t samples[] = { U'a', U'~', 0x7f, 0x80, 0x7ff, 0x800,
+                                     0xd7ff, 0xe000, 0xfffd, 0xffff,
+                                     0x10000, 0x10ffff };
+
+        for (int i = 0; i < 20000; ++i)
+        {
+            std::string text;
+            const auto length = rng() % 100;
+            while (text.size() < length)
+            {
+                text += encode(samples[rng() % std::size(samples)]);
+            }
+
+            // corrupt a byte some of the time
+            if (!text.empty() && i % 2 == 0)
+            {
+                text[rng() % text.size()] = static_cast<char>(rng());
+            }
+
+            CAPTURE(i);
+            check_validators(text);
+        }
+    }
+}
+
+TEST_CASE("utf8 parsers")
+{
+    using namespace std::string_view_literals;
+    namespace cc = ptcore::char_classes;
+
+    SUBCASE("valid_utf8")
+    {
+        constexpr auto p = ptcore::valid_utf8();
+        static_assert(p("ok\xe2\x82\xac\xff!")->value == "ok\xe2\x82\xac"sv);
+        static_assert(p("ok\xe2\x82\xac\xff!")->remaining_input == "\xff!"sv);
+        static_assert(ptcore::match_entirety(p)("\xc3\xa9t\xc3\xa9"));
+        static_assert(!ptcore::match_entirety(p)("\xc3"));
+    }
+
+    SUBCASE("match_code_point")
+    {
+        constexpr auto any = ptcore::match_code_point();
+        static_assert(any("\xe2\x82\xac!")->value == U'€');
+        static_assert(any("\xe2\x82\xac!")->remaining_input == "!"sv);
+        static_assert(any("a")->value == U'a');
+        static_assert(!any("\xe2\x82"));
+        static_assert(!any(""));
+
+        constexpr auto greek = ptcore::match_code_point(
+            cc::digit, ptcore::code_point_range{ 0x391, 0x3c9 });
+        static_assert(greek("\xce\xb1")->value == U'α');
+        static_assert(greek("7")->value == U'7');
+        static_assert(!greek("a"));
+        static_assert(!greek("\xc3\xa9"));
+
+        static_assert(ptcore::info(greek).min_length == 1);
+        static_assert(ptcore::info(greek).max_length == 4);
+    }
+
+    SUBCASE("match_code_point_run")
+    {
+        // letters in Latin-1 and Latin Extended-A as well as ASCII
+        constexpr auto word = ptcore::match_code_point_run(
+            cc::alpha, ptcore::code_point_range{ 0xc0, 0x17f });
+
+        static_assert(word("na\xc3\xafve caf\xc3\xa9")->value ==
+                      "na\xc3\xafve"sv);
+        static_assert(word("\xc5\x93uvre.")->remaining_input == "."sv);
+        static_assert(!word(" word"));
+        static_assert(!word("\xe2\x82\xac"));
+
+        // an invalid sequence ends the run
+        static_assert(word("ab\xc3")->value == "ab"sv);
+
+        // long ASCII runs take the SIMD scan
+        std::string text(1000, 'x');
+        text += "\xc3\xa9";
+        text += std::string(1000, 'y');
+        text += "\xe2\x82\xac";
+
+        const auto r = word(text);
+        REQUIRE(r);
+        CHECK(r->value.size() == 2002);
+        CHECK(r->remaining_input == "\xe2\x82\xac"sv);
+
+        constexpr auto any =
+            ptcore::match_code_point_run(~ptcore::char_class{});
+        CHECK(any(text)->remaining_input.empty());
+    }
+}